@@ -245,6 +245,7 @@ void set_fault(int router_addr, int subnet, int input_port){
 	}
 }
 
+//CS subnets are always a 2D mesh (only the PS NoC has the torus wraparound links), so the path search keeps the Manhattan distance
 int Manhattan(int xi, int yi, int xj, int yj){
 	return (abs(xi - xj) + abs(yi - yj));
 }
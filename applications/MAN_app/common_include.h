@@ -47,6 +47,73 @@
 
 #define putsv(string, value) Puts(string); Puts(itoa(value)); Puts("\n");
 
+#ifndef TORUS_TOPOLOGY
+#define TORUS_TOPOLOGY	0
+#endif
+
+/** Number of PS NoC hops in one dimension. In the torus the routers only cross a wraparound link
+ * when the target is at the edge on the other side of it (dateline rule of switch_control)
+ * \param l Source coordinate
+ * \param t Target coordinate
+ * \param n Dimension size
+ */
+int dimension_hops(int l, int t, int n){
+	int hops;
+
+	hops = abs(l - t);
+
+#if TORUS_TOPOLOGY
+	if (t == 0 && l != 0 && (n - l) < hops)
+		hops = n - l;
+	else if (t == n-1 && l != t && (l + 1) < hops)
+		hops = l + 1;
+#endif
+
+	return hops;
+}
+
+/** Number of PS NoC hops between two PEs, according with the NoC topology. Use it instead of
+ * the Manhattan distance in the mapping heuristics
+ * \param xi X address of source PE
+ * \param yi Y address of source PE
+ * \param xj X address of target PE
+ * \param yj Y address of target PE
+ */
+int hop_distance(int xi, int yi, int xj, int yj){
+	return dimension_hops(xi, xj, XDIMENSION) + dimension_hops(yi, yj, YDIMENSION);
+}
+
+#ifndef APP_INJECTOR_NUMBER
+#define APP_INJECTOR_NUMBER		1
+#define APP_INJECTOR_LIST		{APP_INJECTOR}
+#endif
+
+unsigned int app_injectors[APP_INJECTOR_NUMBER] = APP_INJECTOR_LIST; //!< Hot encoded address of each application injector, APP_INJECTOR is the first one
+
+/** Returns the application injector with the shortest path to a PE. Requesting the task code to this injector
+ * spreads the TASK_ALLOCATION packets over the MPSoC borders
+ * \param proc Address of the PE (x << 8 | y)
+ */
+unsigned int nearest_app_injector(unsigned int proc){
+	unsigned int nearest;
+	int hops, min_hops;
+
+	nearest = app_injectors[0];
+	min_hops = 0x7FFFFFFF;
+
+	for(int i=0; i<APP_INJECTOR_NUMBER; i++){
+
+		hops = hop_distance((app_injectors[i] >> 8) & 0xFF, app_injectors[i] & 0xFF, proc >> 8, proc & 0xFF);
+
+		if (hops < min_hops){
+			min_hops = hops;
+			nearest = app_injectors[i];
+		}
+	}
+
+	return nearest;
+}
+
 //#define MAX_MAPPING_MSG		100
 //#define MAX_MANAG_MSG_SIZE (XDIMENSION*YDIMENSION*CS_NETS)
 #define MAX_MANAG_MSG_SIZE	100
@@ -29,16 +29,17 @@ void send_task_allocation_message(unsigned int task_repo_id, unsigned int real_t
 	unsigned int * message;
 
 	message = get_message_slot();
-	message[0] = APP_INJECTOR; //Destination
-	message[1] = 5; //Packet size
+	message[0] = nearest_app_injector(allocated_proc); //Destination
+	message[1] = 6; //Packet size
 	message[2] = APP_ALLOCATION_REQUEST; //Service
 	message[3] = task_repo_id; //Repository task ID
 	message[4] = master_addr; //Master address
 	message[5] = allocated_proc;
 	message[6] = real_task_id; //Real task id, when zero means to injector to ignore this flit. Otherwise, force the task ID to assume the specified ID value
+	message[7] = 0; //Not cached, the global mapper does not track the task code cache
 
 	//Send message to Peripheral
-	SendRaw(message, 7);
+	SendRaw(message, 8);
 
 	while(!NoCSendFree());
 
@@ -355,19 +356,21 @@ void handle_i_am_alive(unsigned int source_addr, unsigned int task_id){
 
 		Puts("\nInitializing ALL MA TASKS complete\n");
 
-		/*Sending MAPPING COMPLETE to APP INJECTOR*/
-		message = get_message_slot();
-		message[0] = APP_INJECTOR;
-		message[1] = 2;//Payload should be 1, but is 2 in order to turn around a corner case in traffic monitor of Deloream for packets with payload 1
-		message[2] = APP_MAPPING_COMPLETE;
-		SendRaw(message, 4);
+		/*Sending MAPPING COMPLETE to all APP INJECTORS, releasing them to request applications*/
+		for(int i=0; i<APP_INJECTOR_NUMBER; i++){
+			message = get_message_slot();
+			message[0] = app_injectors[i];
+			message[1] = 2;//Payload should be 1, but is 2 in order to turn around a corner case in traffic monitor of Deloream for packets with payload 1
+			message[2] = APP_MAPPING_COMPLETE;
+			SendRaw(message, 4);
 
-		while(!NoCSendFree());
+			while(!NoCSendFree());
+		}
 	}
 
 }
 
-void handle_new_app_req(unsigned int app_cluster_id, unsigned int app_task_number){
+void handle_new_app_req(unsigned int app_cluster_id, unsigned int app_task_number, unsigned int injector){
 
 	static unsigned int app_id_counter = 1;
 	unsigned int cluster_loc;
@@ -377,12 +380,12 @@ void handle_new_app_req(unsigned int app_cluster_id, unsigned int app_task_numbe
 		app_cluster_id = CLUSTER_NUMBER;
 
 	if (app_task_number > total_mpsoc_resources){
-		pending_app_req = app_task_number << 16 | app_cluster_id;
+		pending_app_req[injector] = app_task_number << 16 | app_cluster_id;
 		Puts("Cluster full - return\n");
 		return;
 	}
 
-	pending_app_req = 0;
+	pending_app_req[injector] = 0;
 
 	Puts("\n\n******** NEW_APP_REQ **********\n");
 	//Puts(itoa(app_cluster_id));
@@ -409,9 +412,11 @@ void handle_new_app_req(unsigned int app_cluster_id, unsigned int app_task_numbe
 
 	//Puts("Cluster loc "); Puts(itoa(cluster_loc)); Puts("\n");
 
-	/*Sends packet to APP INJECTOR requesting repository to cluster app_cluster_id*/
+	/*Sends packet to the requesting APP INJECTOR, which transfers the repository to cluster app_cluster_id*/
+	mapping_app_id[injector] = app_id_counter;
+
 	message = get_message_slot();
-	message[0] = APP_INJECTOR;
+	message[0] = app_injectors[injector];
 	message[1] = 3; //Payload size
 	message[2] = APP_REQ_ACK;
 	message[3] = app_id_counter;
@@ -464,18 +469,19 @@ void handle_app_terminated(unsigned int *msg){
 		MemoryWrite(END_SIM,1);
 	}*/
 	//pending_app_req = app_task_number << 16 | app_cluster_id;
-	if (pending_app_req){
-		Puts("Pending APP to req TRUE\n");
-		app_task_number = pending_app_req >> 16;
-		original_cluster_index = pending_app_req & 0xFF;
-
-		handle_new_app_req(original_cluster_index, app_task_number);
+	for(int i=0; i<APP_INJECTOR_NUMBER; i++){
+		if (pending_app_req[i]){
+			Puts("Pending APP to req TRUE\n");
+			app_task_number = pending_app_req[i] >> 16;
+			original_cluster_index = pending_app_req[i] & 0xFF;
 
+			handle_new_app_req(original_cluster_index, app_task_number, i);
+		}
 	}
 }
 
 void handle_app_allocated(unsigned int * msg){
-	unsigned int cluster_index, index, app_task_number;
+	unsigned int cluster_index, index, app_task_number, injector;
 	unsigned int * message;
 
 	putsv("\n******************************\nReceive APP_ALLOCATED for app ", msg[1]);
@@ -488,8 +494,13 @@ void handle_app_allocated(unsigned int * msg){
 		allocate_cluster_resource(cluster_index, 1);
 	}
 
+	//Releases the injector that requested this application
+	for(injector=0; injector<APP_INJECTOR_NUMBER-1; injector++)
+		if (mapping_app_id[injector] == msg[1])
+			break;
+
 	message = get_message_slot();
-	message[0] = APP_INJECTOR;
+	message[0] = app_injectors[injector];
 	message[1] = 2; //Payload should be 1, but is 2 in order to turn around a corner case in traffic monitor of Deloream for packets with payload 1
 	message[2] = APP_MAPPING_COMPLETE; //Service
 	SendRaw(message, 4);
@@ -504,7 +515,7 @@ void handle_message(unsigned int * data_msg){
 			handle_i_am_alive(data_msg[1], data_msg[2]);
 			break;
 		case NEW_APP_REQ:
-			handle_new_app_req(data_msg[1], data_msg[2]);
+			handle_new_app_req(data_msg[1], data_msg[2], data_msg[3]);
 			break;
 		case APP_ALLOCATED:
 			handle_app_allocated(data_msg);
@@ -529,7 +540,10 @@ void main(){
 	Puts("Initializing Global Mapper\n");
 
 	//Initialize global variables
-	pending_app_req = 0;
+	for(int i=0; i<APP_INJECTOR_NUMBER; i++){
+		pending_app_req[i] = 0;
+		mapping_app_id[i] = 0;
+	}
 	total_mpsoc_resources = (MAX_LOCAL_TASKS * XDIMENSION * YDIMENSION) - 1; //Minus 1 due global mapper
 
 	init_message_slots();
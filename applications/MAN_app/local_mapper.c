@@ -88,13 +88,14 @@ void send_app_allocation_request(Application * app_ptr){
 
 		while(!NoCSendFree());
 
-		message[msg_size++] = APP_INJECTOR; //Destination
-		message[msg_size++] = 5; //Packet size
+		message[msg_size++] = nearest_app_injector(task_ptr->allocated_proc); //Destination
+		message[msg_size++] = 6; //Packet size
 		message[msg_size++] = APP_ALLOCATION_REQUEST; //Service
 		message[msg_size++] = task_ptr->id; //Repository task ID
 		message[msg_size++] = master_addr; //Master address
 		message[msg_size++] = task_ptr->allocated_proc;
 		message[msg_size++] = 0; //Real task id, when zero means to injector to ignore this flit. Otherwise, force the task ID to assume the specified ID value
+		message[msg_size++] = use_cached_code(task_ptr->allocated_proc, task_ptr->code_hash); //When 1 the task code is already into a free page of the PE
 
 	}
 	//Send message to Peripheral
@@ -290,7 +291,36 @@ void handle_task_allocated(unsigned int task_id){
 	}
 }
 
-void handle_task_terminated(unsigned int task_id, unsigned int master_addr){
+/** Handles a CODE_CACHE_MISS sent by a kernel slave when the cached task code was not found into its free pages.
+ * The allocation is requested again to the app injector sending the whole task code
+ *  \param task_id ID of the task being allocated
+ */
+void handle_code_cache_miss(unsigned int task_id){
+
+	Task * task_ptr;
+	unsigned int * message;
+
+	putsv("CODE_CACHE_MISS received from task: ", task_id);
+
+	task_ptr = get_task_ptr(get_application_ptr(task_id >> 8), task_id);
+
+	message = get_message_slot();
+
+	while(!NoCSendFree());
+
+	message[0] = nearest_app_injector(task_ptr->allocated_proc); //Destination
+	message[1] = 6; //Packet size
+	message[2] = APP_ALLOCATION_REQUEST; //Service
+	message[3] = task_ptr->id; //Repository task ID
+	message[4] = (my_task_ID << 16) | net_address; //Master address
+	message[5] = task_ptr->allocated_proc;
+	message[6] = 0; //Real task id
+	message[7] = 0; //Not cached
+
+	SendRaw(message, 8);
+}
+
+void handle_task_terminated(unsigned int task_id, unsigned int master_addr, unsigned int code_hash){
 	Application * app_ptr;
 	Task * task_ptr;
 	unsigned int master_address;
@@ -311,13 +341,15 @@ void handle_task_terminated(unsigned int task_id, unsigned int master_addr){
 
 	if (task_ptr->borrowed_master == -1){
 		page_released(task_ptr->allocated_proc, task_id);
+		add_cached_code(task_ptr->allocated_proc, code_hash);
 		//Puts("Task is local, page released\n");
 	} else {
 		message = get_message_slot();
 		message[0] = TASK_TERMINATED_OTHER_CLUSTER;
 		message[1] = task_ptr->allocated_proc;
 		message[2] = task_id;
-		send(task_ptr->borrowed_master, message, 3);
+		message[3] = code_hash;
+		send(task_ptr->borrowed_master, message, 4);
 		Puts("Sending TASK_TERMINATED_OTHER_CLUSTER to "); Puts(itoh(task_ptr->borrowed_master)); Puts("\n");
 	}
 
@@ -352,6 +384,25 @@ void handle_task_terminated(unsigned int task_id, unsigned int master_addr){
 	}
 }
 
+/** Updates the processor slack time with the value measured by the performance counters of a slave PE.
+ * The slack time is used by the mapping heuristic to choose among the free processors
+ * \param msg PERF_COUNTERS_REPORT message: proc_addr, slack_time
+ */
+void handle_perf_counters_report(unsigned int * msg){
+
+	unsigned int proc_addr;
+
+	proc_addr = msg[1];
+
+	//Processors borrowed from other clusters are not managed by this local mapper
+	for(int i=0; i<MAX_PROCESSORS; i++){
+		if (get_proc_address(i) == proc_addr){
+			update_proc_slack_time(proc_addr, msg[2]);
+			break;
+		}
+	}
+}
+
 void handle_message(unsigned int * data_msg){
 
 	switch (data_msg[0]) {
@@ -365,11 +416,15 @@ void handle_message(unsigned int * data_msg){
 			handle_task_allocated(data_msg[1]);
 			break;
 		case TASK_TERMINATED:
-			handle_task_terminated(data_msg[1], data_msg[2]);
+			handle_task_terminated(data_msg[1], data_msg[2], data_msg[3]);
 			break;
 		case TASK_TERMINATED_OTHER_CLUSTER:
 			//			  proc_addr,    task_id
 			page_released(data_msg[1], data_msg[2]);
+			add_cached_code(data_msg[1], data_msg[3]);
+			break;
+		case CODE_CACHE_MISS:
+			handle_code_cache_miss(data_msg[1]);
 			break;
 
 		case LOAN_PROCESSOR_REQUEST:
@@ -378,6 +433,9 @@ void handle_message(unsigned int * data_msg){
 
 			handle_reclustering(data_msg);
 
+			break;
+		case PERF_COUNTERS_REPORT:
+			handle_perf_counters_report(data_msg);
 			break;
 		default:
 			putsv("ERROR: message unknown, time: ", GetTick());
@@ -23,7 +23,8 @@ typedef struct {
 /*Global Variables*/
 Cluster clusters[MAPPING_CLUSTER_NUMBER];
 unsigned int total_mpsoc_resources = (MAX_LOCAL_TASKS * XDIMENSION * YDIMENSION);
-unsigned int pending_app_req = 0;
+unsigned int pending_app_req[APP_INJECTOR_NUMBER];		//!< Application request waiting for resources, one per injector
+unsigned int mapping_app_id[APP_INJECTOR_NUMBER];		//!< ID of the application being mapped for each injector
 
 
 void intilize_clusters(){
@@ -46,6 +46,7 @@ typedef struct {
 	int  code_size;					//!< Stores the task code size - loaded from repository
 	int  data_size;					//!< Stores the DATA memory section size - loaded from repository
 	int  bss_size;					//!< Stores the BSS memory section size - loaded from repository
+	unsigned int code_hash;			//!< Stores the hash of the task code - loaded from repository, used by the task code cache
 	int  allocated_proc;			//!< Stores the allocated processor address of the task
 	int  computation_load;			//!< Stores the computation load
 	int  borrowed_master;			//!< Stores the borrowed master address
@@ -117,13 +118,11 @@ Application * get_application_ptr(int app_id){
  */
 Task * get_task_ptr(Application * app, int task_id){
 
-	for(int i=0; i<app->tasks_number; i++){
-
-		if (app->tasks[i].id == task_id){
+	//The tasks array is indexed by the task id into the application, see read_and_create_application
+	if ((task_id & 0xFF) < MAX_TASKS_APP && app->tasks[task_id & 0xFF].id == task_id){
 
-			return &app->tasks[i];
+		return &app->tasks[task_id & 0xFF];
 
-		}
 	}
 
 	Puts("ERROR: Task not found "); Puts(itoa(task_id)); Puts("\n");
@@ -250,7 +249,7 @@ Application * read_and_create_application(unsigned int app_id, unsigned int * re
 		tp->code_size = *(ref_address++);
 		tp->data_size = *(ref_address++);
 		tp->bss_size = *(ref_address++);
-		/*tp->initial_address =*/ ref_address++;
+		tp->code_hash = *(ref_address++); //The app injector replaces the initial address by the code hash
 		tp->dependences_number = 0;
 		tp->computation_load = 0;
 		tp->id = app_id << 8 | task_id;
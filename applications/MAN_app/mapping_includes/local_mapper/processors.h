@@ -10,6 +10,7 @@
 
 #include "../../common_include.h"
 #include "globals.h"
+#include "application.h"
 
 /**
  * \brief This structure store variables used to manage the processors attributed by the kernel master
@@ -20,6 +21,7 @@ typedef struct {
 	int slack_time;						//!<Slack time (idle time), represented in percentage
 	unsigned int total_slack_samples;	//!<Number of slack time samples
 	int task[MAX_LOCAL_TASKS]; 			//!<Array with the ID of all task allocated in a given processor
+	unsigned int code_cache[MAX_LOCAL_TASKS];	//!<Hashes of the task codes kept into the free pages of the processor, 0 means empty
 } Processor;
 
 
@@ -44,6 +46,10 @@ int get_proc_address(int);
 
 int get_task_location(int);
 
+void add_cached_code(int, unsigned int);
+
+int use_cached_code(int, unsigned int);
+
 
 
 /**Internal function to search by a processor - not visible to the other software part
@@ -117,6 +123,7 @@ void add_procesor(int proc_address){
 
 	for(int i=0; i<MAX_LOCAL_TASKS; i++){
 		p->task[i] = -1;
+		p->code_cache[i] = 0;
 	}
 
 	Puts("Adding processor address "); Puts(itoh(proc_address)); Puts("\n");
@@ -197,12 +204,28 @@ int get_proc_free_pages(int proc_address){
 
 }
 
-/**Searches for a task location by walking for all processors within processors' array
+/**Searches for a task location. The tasks of the applications are direct-indexed into the Application structure,
+ * the other tasks (MA tasks) are searched by walking for all processors within processors' array
  * \param task_id Task ID
  * \return The task location, i.e., the processor address that the task is allocated
  */
 int get_task_location(int task_id){
 
+	Task * t;
+
+	for(int i=0; i<MAX_CLUSTER_TASKS; i++){
+
+		if (applications[i].app_ID != (task_id >> 8) || (task_id & 0xFF) >= MAX_TASKS_APP){
+			continue;
+		}
+
+		t = &applications[i].tasks[task_id & 0xFF];
+
+		if (t->id == task_id && t->status != TERMINATED_TASK && t->allocated_proc != -1){
+			return t->allocated_proc;
+		}
+	}
+
 	for(int i=0; i<MAX_PROCESSORS; i++){
 
 		if (processors[i].free_pages == MAX_LOCAL_TASKS || processors[i].address == -1){
@@ -222,6 +245,77 @@ int get_task_location(int task_id){
 	return -1;
 }
 
+/**Internal function to search by a processor without halting when it is not found - not visible to the other software part.
+ * Processors borrowed from other clusters are not into the processors' array
+ * \param proc_address Processor address to be searched
+ * \return The processor pointer, 0 if the processor is not managed by this cluster
+ */
+Processor * search_cluster_processor(int proc_address){
+
+	for(int i=0; i<MAX_PROCESSORS; i++){
+		if (processors[i].address == proc_address){
+			return &processors[i];
+		}
+	}
+	return 0;
+}
+
+/**Records that the code of a terminated task remains into a free page of the processor (task code cache).
+ * This is only a hint, the kernel checks the code hash of the page before reusing it
+ * \param proc_address Processor address
+ * \param code_hash Hash of the task code
+ */
+void add_cached_code(int proc_address, unsigned int code_hash){
+
+	Processor * p = search_cluster_processor(proc_address);
+
+	if (p == 0 || code_hash == 0)
+		return;
+
+	for(int i=0; i<MAX_LOCAL_TASKS; i++){
+		if (p->code_cache[i] == 0){
+			p->code_cache[i] = code_hash;
+			return;
+		}
+	}
+
+	p->code_cache[0] = code_hash;
+}
+
+/**Checks if the code of a task being allocated is kept into a free page of the processor. Must be called after the
+ * page is used by the task. The entries exceeding the free pages are dropped since their pages were overwritten
+ * \param proc_address Processor address
+ * \param code_hash Hash of the task code
+ * \return 1 if the code is cached, then the task code is not sent again, 0 otherwise
+ */
+int use_cached_code(int proc_address, unsigned int code_hash){
+
+	Processor * p = search_cluster_processor(proc_address);
+	int cached = 0;
+	int entries = 0;
+
+	if (p == 0 || code_hash == 0)
+		return 0;
+
+	for(int i=0; i<MAX_LOCAL_TASKS; i++){
+		if (!cached && p->code_cache[i] == code_hash){
+			p->code_cache[i] = 0;
+			cached = 1;
+		} else if (p->code_cache[i] != 0){
+			entries++;
+		}
+	}
+
+	for(int i=0; i<MAX_LOCAL_TASKS && entries > p->free_pages; i++){
+		if (p->code_cache[i] != 0){
+			p->code_cache[i] = 0;
+			entries--;
+		}
+	}
+
+	return cached;
+}
+
 /**Initializes the processors's array with invalid values
  */
 void init_procesors(){
@@ -237,6 +331,7 @@ void init_procesors(){
 		processors[i].slack_time = 100;
 		for(int t=0; t<MAX_LOCAL_TASKS; t++){
 			processors[i].task[t] = -1;
+			processors[i].code_cache[t] = 0;
 		}
 	}
 
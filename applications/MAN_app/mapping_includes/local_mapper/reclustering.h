@@ -276,7 +276,7 @@ void handle_reclustering(unsigned int * msg){
 			curr_x = (mapped_proc >> 8);
 			curr_y = (mapped_proc & 0xFF);
 
-			hops = (abs(ref_x - curr_x) + abs(ref_y - curr_y));
+			hops = hop_distance(ref_x, ref_y, curr_x, curr_y);
 
 #if RECLUSTERING_DEBUG
 			Puts("Alocou proc "); Puts(itoh(mapped_proc)); putsv(" hops ", hops); Puts("\n");
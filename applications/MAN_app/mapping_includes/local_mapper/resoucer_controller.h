@@ -106,7 +106,7 @@ int application_mapping(int app_id){
 					yj = initial_pe_list[j] & 0xFF;
 
 					//Computes the manhatam distance
-					man_curr = (abs(xi - xj) + abs(yi - yj));
+					man_curr = hop_distance(xi, yi, xj, yj);
 
 					man_sum = man_sum + man_curr;
 					man_count++;
@@ -175,13 +175,14 @@ int application_mapping(int app_id){
 int reclustering_map(int ref_proc){
 
 	int ref_x, ref_y, curr_x, curr_y, proc_address;
-	int curr_man, min_man, sel_proc;
+	int curr_man, min_man, sel_proc, sel_slack;
 
 	ref_x = ref_proc >> 8;
 	ref_y = ref_proc & 0xFF;
 
 	min_man = (XDIMENSION*YDIMENSION);
 	sel_proc = -1;
+	sel_slack = 0;
 
 	//Else, selects the pe with the minimal manhatam to the initial proc
 	for(int i=0; i<MAX_PROCESSORS; i++){
@@ -193,11 +194,13 @@ int reclustering_map(int ref_proc){
 
 		if (get_proc_free_pages(proc_address) > 0){
 
-			curr_man = (abs(ref_x - curr_x) + abs(ref_y - curr_y));
+			curr_man = hop_distance(ref_x, ref_y, curr_x, curr_y);
 
-			if (curr_man < min_man){
+			//At the same distance, the processor with the highest slack time is selected
+			if (curr_man < min_man || (curr_man == min_man && get_proc_slack_time(proc_address) > sel_slack)){
 				min_man = curr_man;
 				sel_proc = proc_address;
+				sel_slack = get_proc_slack_time(proc_address);
 			}
 		}
 	}
@@ -205,7 +208,8 @@ int reclustering_map(int ref_proc){
 	return sel_proc;
 }
 
-/** Searches following the diamond search paradigm. The search occurs only inside cluster
+/** Searches following the diamond search paradigm. The search occurs only inside cluster.
+ * Among the free processors at the same distance, the one with the highest measured slack time is selected
  * \param current_allocated_pe Current PE of the target task
  * \param last_proc The last proc returned by diamond_search function. 0 if is the first call
  * \return The selected processor address. -1 if not found
@@ -214,7 +218,7 @@ int diamond_search_initial(int begining_core){
 
 	int ref_x, ref_y, max_round, hop_count, max_tested_proc;//XY address of the current processor of the task
 	int proc_x, proc_y, proc_count;
-	int candidate_proc;
+	int candidate_proc, candidate_slack, slack;
 	int max_x, max_y, min_x, min_y;
 
 	ref_x = (begining_core >> 8);
@@ -252,6 +256,7 @@ int diamond_search_initial(int begining_core){
 		//Puts(itoa(proc_x)); putsv("x", proc_y);
 
 		candidate_proc = -1;//Init the variable to start the looping below
+		candidate_slack = 0;
 		//putsv("-------- New round: ", max_round);
 
 		//Walks for all processor of the round
@@ -266,12 +271,14 @@ int diamond_search_initial(int begining_core){
 				//Increment the number of valid processors visited
 				proc_count++;
 
-				//Tests if the processor is available, if yes, mark it as used in free_core_map and return
+				//Tests if the processor is available, among the ones of the round selects the highest slack time
 				if(get_proc_free_pages(proc_x << 8 | proc_y)){
 				//if (free_core_map[proc_x][proc_y] == 1){
-					candidate_proc = proc_x << 8 | proc_y;
-					//Puts("Proc selected: "); Puts(itoh(candidate_proc)); Puts("\n");
-					return candidate_proc;
+					slack = get_proc_slack_time(proc_x << 8 | proc_y);
+					if (candidate_proc == -1 || slack > candidate_slack){
+						candidate_proc = proc_x << 8 | proc_y;
+						candidate_slack = slack;
+					}
 				}
 
 			}
@@ -296,6 +303,11 @@ int diamond_search_initial(int begining_core){
 			}
 		}
 
+		if (candidate_proc != -1){
+			//Puts("Proc selected: "); Puts(itoh(candidate_proc)); Puts("\n");
+			return candidate_proc;
+		}
+
 	}
 
 	return -1;
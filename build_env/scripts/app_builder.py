@@ -187,6 +187,9 @@ def generate_repository(yaml_r, testcase_dir, app_path, app_name):
     #Here the repository for each task must be writed
     generate_app_repository_file(app_name, app_path, repo_lines, get_model_description(yaml_r))
     
+    if get_task_code_compression(yaml_r):
+        generate_compressed_repository_file(app_path, task_name_list, get_page_size_KB(yaml_r) * 1024)
+    
     ################Finally, generates the repository file (main and debug files) ##########################
     print "***************** End task page size report ********************\n"
 
@@ -221,6 +224,115 @@ def generate_app_repository_file(app_name, app_path, repo_lines, system_model_de
     writes_file_into_testcase(repo_file_path, file_lines)
     writes_file_into_testcase(repo_debug_file_path, file_debug_lines)
 
+#Task code compression, the stream is decoded by the kernel (see decompress_task_code in enforcer_mapping.c):
+#word 0 is the number of words of the token stream, followed by the token stream and by the dictionary.
+#The token stream is a sequence of bytes, packed from the most significant byte of each word:
+# 0x00-0x7F: dictionary word
+# 0x80-0xBF: run of (tag & 0x3F) + 1 literal words, each one in the next 4 bytes
+# 0xC0-0xFF: copy of (tag & 0x3F) + 2 words already decoded, the next 2 bytes store the distance in words
+COMP_DICT_SIZE      = 128
+COMP_MAX_LITERALS   = 64
+COMP_MAX_COPY       = 65
+COMP_MAX_DISTANCE   = 65535
+
+def compress_task_code(words):
+    
+    #The most frequent words of the task code (e.g. nop, stack and return address handling) forms the dictionary
+    frequency = {}
+    for w in words:
+        frequency[w] = frequency.get(w, 0) + 1
+    dictionary = [w for w in sorted(frequency, key=lambda w: -frequency[w]) if frequency[w] > 1][0:COMP_DICT_SIZE]
+    dict_index = dict((w, i) for i, w in enumerate(dictionary))
+    
+    tokens = []
+    literals = []
+    positions = {} #Last positions of each pair of words, used to search the copies
+    max_overlap = 0 #Largest distance reached between decoded and consumed bytes, used to validate in-place decoding
+    i = 0
+    
+    while i < len(words):
+        
+        #Longest copy among the last positions of the current pair of words
+        copy_len = 0
+        copy_dist = 0
+        if i + 1 < len(words):
+            for p in positions.get((words[i], words[i+1]), []):
+                if i - p > COMP_MAX_DISTANCE:
+                    continue
+                l = 0
+                while l < COMP_MAX_COPY and i + l < len(words) and words[p + l] == words[i + l]:
+                    l = l + 1
+                if l > copy_len:
+                    copy_len = l
+                    copy_dist = i - p
+        
+        in_dict = words[i] in dict_index and (i + 1 >= len(words) or words[i+1] in dict_index)
+        
+        if copy_len >= 3 or (copy_len == 2 and not in_dict):
+            token = [0xC0 | (copy_len - 2), copy_dist >> 8, copy_dist & 0xFF]
+            step = copy_len
+        elif words[i] in dict_index:
+            token = [dict_index[words[i]]]
+            step = 1
+        else:
+            literals.append(words[i])
+            step = 1
+            token = None
+        
+        #Flushes the pending literals before the current token or when the run is full
+        if (token != None or len(literals) == COMP_MAX_LITERALS or i + step == len(words)) and len(literals) > 0:
+            tokens.append(0x80 | (len(literals) - 1))
+            for w in literals:
+                tokens.extend([(w >> 24) & 0xFF, (w >> 16) & 0xFF, (w >> 8) & 0xFF, w & 0xFF])
+            max_overlap = max(max_overlap, (i + (token == None)) * 4 - (len(tokens) + 4))
+            literals = []
+        
+        if token != None:
+            tokens.extend(token)
+            max_overlap = max(max_overlap, (i + step) * 4 - (len(tokens) + 4))
+        
+        for j in range(i, i + step):
+            if j + 1 < len(words):
+                pair = (words[j], words[j+1])
+                positions[pair] = (positions.get(pair, []) + [j])[-16:]
+        
+        i = i + step
+    
+    while len(tokens) % 4 != 0:
+        tokens.append(0)
+    
+    stream = [len(tokens) / 4]
+    for b in range(0, len(tokens), 4):
+        stream.append(tokens[b] << 24 | tokens[b+1] << 16 | tokens[b+2] << 8 | tokens[b+3])
+    stream.extend(dictionary)
+    
+    return stream, max_overlap
+
+#Generates the repository_lz.txt, which stores for each task the compressed code size in words followed by the compressed code.
+#The size is 0 when the compression does not reduce the code or when the kernel cannot decode it in place at the top of the page
+def generate_compressed_repository_file(app_path, task_name_list, page_size_bytes):
+    
+    file_lines = []
+    
+    for task_name in task_name_list:
+        
+        words = [int(line[0:8], 16) for line in open(app_path + "/" + task_name + ".txt", "r")]
+        
+        stream, max_overlap = compress_task_code(words)
+        
+        #The kernel receives the stream at the end of the page, the decoded code cannot reach the bytes not consumed yet
+        if len(stream) >= len(words) or max_overlap > page_size_bytes - (len(stream) * 4):
+            print "Task code compression disabled for "+task_name
+            stream = []
+        else:
+            print "Task code of "+task_name+" compressed from "+str(len(words))+" to "+str(len(stream))+" words"
+        
+        file_lines.append(toX(len(stream))+"\n")
+        for w in stream:
+            file_lines.append(toX(w)+"\n")
+    
+    writes_file_into_testcase(app_path + "/repository_lz.txt", file_lines)
+
 def get_task_txt_size(app_path, task_name):
     
     source_file = app_path + "/" + task_name + ".txt"
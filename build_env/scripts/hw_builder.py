@@ -31,6 +31,50 @@ def generate_hw_pkg( yaml_r ):
     y_cluster_dim =     get_cluster_y_dim(yaml_r)
     system_model_desc = get_model_description(yaml_r)
     IO_peripherals =    get_IO_peripherals(yaml_r)
+    topology =          get_topology(yaml_r)
+    msg_request_table = get_msg_request_table(yaml_r)
+    app_injectors =     get_app_injectors(yaml_r)
+    
+    if topology != "mesh" and topology != "torus":
+        sys.exit("ERROR: Invalid topology '"+str(topology)+"', supported values are: mesh | torus")
+    
+    if topology == "torus" and system_model_desc == "vhdl":
+        sys.exit("ERROR: torus topology is only supported by the SystemC model description (sc | scmod)")
+    
+    if msg_request_table and system_model_desc == "vhdl":
+        sys.exit("ERROR: msg_request_table is only supported by the SystemC model description (sc | scmod)")
+    
+    if get_dvfs(yaml_r) and system_model_desc == "vhdl":
+        sys.exit("ERROR: dvfs is only supported by the SystemC model description (sc | scmod)")
+    
+    traffic_generator = get_traffic_generator(yaml_r)
+    if traffic_generator != None and system_model_desc == "vhdl":
+        sys.exit("ERROR: traffic_generator is only supported by the SystemC model description (sc | scmod)")
+    
+    if traffic_generator != None and traffic_generator.get("pattern", "uniform") not in ["uniform", "transpose", "bit_complement", "hotspot", "neighbor"]:
+        sys.exit("ERROR: Invalid traffic_generator pattern, supported values are: uniform | transpose | bit_complement | hotspot | neighbor")
+    
+    #The table keeps one local producer slot per TCB, see MSG_REQUEST_TABLE_TASKS in standards.h
+    if msg_request_table and get_tasks_per_PE(yaml_r) > 8:
+        sys.exit("ERROR: msg_request_table supports up to 8 tasks_per_PE")
+    
+    #One PS subnet plus 1 to 8 CS subnets, the CS router config flit has 8 bits to select the subnet
+    if get_subnet_number(yaml_r) < 2 or get_subnet_number(yaml_r) > 9:
+        sys.exit("ERROR: Invalid subnets number, must be a value between 2 and 9 (1 PS subnet + 1 to 8 CS subnets)")
+    
+    if get_subnet_CS_flit_width(yaml_r) not in [8, 16, 32]:
+        sys.exit("ERROR: Invalid CS_flit_width, supported values are: 8 | 16 | 32")
+    
+    if len(app_injectors) == 0 or app_injectors[0]["name"] != "APP_INJECTOR":
+        sys.exit("ERROR: The Peripherals list must have one APP_INJECTOR")
+    
+    if len(app_injectors) > 1 and system_model_desc == "vhdl":
+        sys.exit("ERROR: multiple application injectors are only supported by the SystemC model description (sc | scmod)")
+    
+    #io_port stores a single IO port per PE
+    injector_pes = [io_peripheral["pe"] for io_peripheral in app_injectors]
+    if len(set(injector_pes)) != len(injector_pes):
+        sys.exit("ERROR: Each application injector must be connected to a different PE")
     
     #-------Gets the PEs that are connected to IO peripherals------
     pe_number = 0
@@ -92,6 +136,10 @@ def generate_to_systemc(io_list, io_name_list, yaml_r):
     y_mpsoc_dim =       get_mpsoc_y_dim(yaml_r)
     subnet_number =     get_subnet_number(yaml_r)
     cs_flit_width =     get_subnet_CS_flit_width(yaml_r)
+    topology =          get_topology(yaml_r)
+    msg_request_table = get_msg_request_table(yaml_r)
+    app_injectors =     get_app_injectors(yaml_r)
+    traffic_generator = get_traffic_generator(yaml_r)
     
 
     string_io_connections_sc = ""
@@ -114,19 +162,47 @@ def generate_to_systemc(io_list, io_name_list, yaml_r):
     file_lines.append("#define TAM_CS_FLIT          "+str(cs_flit_width)+"\n")
     file_lines.append("#define N_PE_X              "+str(x_mpsoc_dim)+"\n")
     file_lines.append("#define N_PE_Y              "+str(y_mpsoc_dim)+"\n")
-    file_lines.append("#define N_PE                "+str(x_mpsoc_dim*y_mpsoc_dim)+"\n\n")
+    file_lines.append("#define N_PE                "+str(x_mpsoc_dim*y_mpsoc_dim)+"\n")
+    file_lines.append("#define TORUS_TOPOLOGY      "+str(int(topology == "torus"))+"\n")
+    file_lines.append("#define MSG_REQUEST_TABLE   "+str(int(msg_request_table))+"\n")
+    file_lines.append("#define TRAFFIC_GENERATOR   "+str(int(traffic_generator != None))+"\n\n")
     
     file_lines.append("//Peripheral Position\n")
     for io_peripheral in io_name_list:
         file_lines.append("#define "+io_peripheral[0]+"\t\t\t"+str(io_peripheral[1])+"\n")
     
     file_lines.append("const char io_port[N_PE]= {"+string_io_connections_sc+"};\n\n")
+    
+    #Index of the PE where each application injector is connected, the first one boots the system
+    string_app_injectors_sc = ""
+    for io_peripheral in app_injectors:
+        string_app_injectors_sc = string_app_injectors_sc + str(int(io_peripheral["pe"][2])*x_mpsoc_dim + int(io_peripheral["pe"][0])) + ", "
+    string_app_injectors_sc = string_app_injectors_sc[0:len(string_app_injectors_sc)-2]
+    
+    file_lines.append("#define APP_INJECTOR_NUMBER "+str(len(app_injectors))+"\n")
+    file_lines.append("const int app_injector_pe[APP_INJECTOR_NUMBER]= {"+string_app_injectors_sc+"};\n\n")
     file_lines.append("#endif\n")
     
     
     #Use this function to create any file into testcase, it automatically only updates the old file if necessary
     writes_file_into_testcase("include/memphis_pkg.h", file_lines)
     
+    if traffic_generator != None:
+        generate_traffic_config(traffic_generator)
+    
+#Writes the configuration read by each traffic generator at the simulation start, see TRAFFIC_CONFIG_FILE in traffic_generator.h
+def generate_traffic_config(traffic_generator):
+    
+    config_lines = []
+    for key in ["pattern", "injection_rate", "packet_size", "hotspot_fraction", "warmup_cycles", "measure_cycles"]:
+        if key in traffic_generator:
+            config_lines.append(key+" "+str(traffic_generator[key])+"\n")
+    
+    if "hotspot" in traffic_generator:
+        config_lines.append("hotspot "+str(traffic_generator["hotspot"][0])+","+str(traffic_generator["hotspot"][1])+"\n")
+    
+    writes_file_into_testcase("traffic_generator.cfg", config_lines)
+    
     
 
 def generate_to_vhdl(io_list, io_name_list, yaml_r):
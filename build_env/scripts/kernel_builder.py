@@ -43,6 +43,9 @@ def generate_sw_pkg( yaml_r ):
     y_cluster_dim =     get_cluster_y_dim(yaml_r)
     IO_peripherals =    get_IO_peripherals(yaml_r)
     subnets_number =    get_subnet_number(yaml_r)
+    topology =          get_topology(yaml_r)
+    model_descr =       get_model_description(yaml_r)
+    msg_request_table = get_msg_request_table(yaml_r)
     cluster_number =    (x_mpsoc_dim*y_mpsoc_dim) / (x_cluster_dim*y_cluster_dim)
     
     
@@ -61,6 +64,16 @@ def generate_sw_pkg( yaml_r ):
     file_lines.append("#define XCLUSTER                    "+str(x_cluster_dim)+"     //cluster x dimension\n") 
     file_lines.append("#define YCLUSTER                    "+str(y_cluster_dim)+"     //cluster y dimension\n")
     file_lines.append("#define CLUSTER_NUMBER              "+str(cluster_number)+"     //total number of cluster\n")
+    file_lines.append("#define TORUS_TOPOLOGY              "+str(int(topology == "torus"))+"     //PS NoC topology: 0 - 2D mesh, 1 - 2D torus\n")
+    file_lines.append("#define DMNI_SEND_RING              "+str(int(model_descr != "vhdl"))+"     //PS packets are queued into the DMNI send descriptor ring (sc and scmod only)\n")
+    file_lines.append("#define DMNI_RECV_COALESCING        "+str(int(model_descr != "vhdl"))+"     //PS receive interrupts are coalesced by the DMNI (sc and scmod only)\n")
+    file_lines.append("#define DMNI_LOCAL_COPY             "+str(int(model_descr != "vhdl"))+"     //Messages between tasks of the same PE are copied by the DMNI (sc and scmod only)\n")
+    file_lines.append("#define MSG_REQUEST_TABLE           "+str(int(msg_request_table))+"     //MESSAGE_REQUEST packets are matched by the hardware message request table (sc and scmod only)\n")
+    file_lines.append("#define PERF_COUNTERS               "+str(int(model_descr != "vhdl"))+"     //Per page performance counters are reported to the local mapper (sc and scmod only)\n")
+    file_lines.append("#define DVFS                        "+str(int(get_dvfs(yaml_r) and model_descr != "vhdl"))+"     //The kernel scales the CPU clock from the slack time and the RT utilization (sc and scmod only)\n")
+    file_lines.append("#define EAGER_MESSAGING             "+str(int(get_eager_messaging(yaml_r)))+"     //Producers push the messages while they hold credits granted by the consumers, MESSAGE_REQUEST is only used without credits\n")
+    file_lines.append("#define OUTBOX_DEPTH                "+str(get_outbox_depth(yaml_r))+"     //Messages buffered by the kernel for each producer task, Send only blocks when the outbox is full - 0 disables the outbox\n")
+    file_lines.append("#define EDF_SCHEDULER               "+str(int(get_task_scheduler(yaml_r) == "edf"))+"     //RT tasks are scheduled by the earliest deadline, round_robin and lst keep the least slack time\n")
     #file_lines.append("#define APP_NUMBER                  "+str(apps_number)+"     //max number of APPs described into testcase file\n")
     
     file_lines.append("//Peripherals\n")
@@ -77,7 +90,11 @@ def generate_sw_pkg( yaml_r ):
             port_encoded = 3221225472 # == 1100 0000 0000 0000 0000 0000 0000 0000 == IO routing On through port North
         elif (port == "S"):
             port_encoded = 3758096384 # == 1110 0000 0000 0000 0000 0000 0000 0000 == IO routing On through port South
-        file_lines.append("#define "+str(io_peripheral["name"])+"            "+hex(port_encoded|pe_addr)+"    //This number is hot encoded (1 k bit + 3 n bits + 12 zeros + 8 x bits + 8 y bits). k bit when on enable routing to external peripheral, n bits signals the port between peripheral and PE, x bits stores the X address of PE, y bits stores the Y address of PE")
+        file_lines.append("#define "+str(io_peripheral["name"])+"            "+hex(port_encoded|pe_addr)+"    //This number is hot encoded (1 k bit + 3 n bits + 12 zeros + 8 x bits + 8 y bits). k bit when on enable routing to external peripheral, n bits signals the port between peripheral and PE, x bits stores the X address of PE, y bits stores the Y address of PE\n")
+    
+    app_injectors = get_app_injectors(yaml_r)
+    file_lines.append("#define APP_INJECTOR_NUMBER         "+str(len(app_injectors))+"      //number of application injectors, APP_INJECTOR is the first one\n")
+    file_lines.append("#define APP_INJECTOR_LIST           {"+", ".join([str(io_peripheral["name"]) for io_peripheral in app_injectors])+"}\n")
          
     file_lines.append("\n\n#endif\n")
     
@@ -66,6 +66,49 @@ def get_subnet_CS_flit_width(yaml_reader):
     except:
         return 8;
 
+def get_topology(yaml_reader):
+    try:
+        return yaml_reader["hw"]["topology"]
+    except:
+        return "mesh";
+
+def get_msg_request_table(yaml_reader):
+    try:
+        return yaml_reader["hw"]["msg_request_table"] == True
+    except:
+        return False;
+
+def get_task_code_compression(yaml_reader):
+    try:
+        return yaml_reader["hw"]["task_code_compression"] == True
+    except:
+        return False;
+
+def get_dvfs(yaml_reader):
+    try:
+        return yaml_reader["hw"]["dvfs"] == True
+    except:
+        return False;
+
+def get_eager_messaging(yaml_reader):
+    try:
+        return yaml_reader["hw"]["eager_messaging"] == True
+    except:
+        return False;
+
+def get_outbox_depth(yaml_reader):
+    try:
+        return int(yaml_reader["hw"]["outbox_depth"])
+    except:
+        return 0;
+
+#Returns the traffic_generator dictionary or None when the synthetic traffic mode is disabled
+def get_traffic_generator(yaml_reader):
+    try:
+        return yaml_reader["hw"]["traffic_generator"]
+    except:
+        return None;
+
 def get_mapping_algorithm(yaml_reader):
     return yaml_reader["sw"]["mapping_algorithm"]
 
@@ -98,7 +141,10 @@ def get_apps_number(yaml_reader):
     return number
 
 def get_task_scheduler(yaml_reader):
-    return yaml_reader["sw"]["task_scheduler"]
+    try:
+        return yaml_reader["sw"]["task_scheduler"]
+    except:
+        return "lst"
 
 def get_app_repo_size(yaml_reader):
     return 1000
@@ -185,6 +231,19 @@ def get_IO_peripherals(yaml_reader):
     except:
         pass
     return to_return
+
+#Returns the application injectors declared into the Peripherals list. Any peripheral named APP_INJECTOR_<n> is an
+#additional injector, APP_INJECTOR is always the first one of the list since it is the injector that boots the system
+def get_app_injectors(yaml_reader):
+    to_return = []
+    
+    for io_peripheral in get_IO_peripherals(yaml_reader):
+        if io_peripheral["name"] == "APP_INJECTOR":
+            to_return.insert(0, io_peripheral)
+        elif str(io_peripheral["name"]).startswith("APP_INJECTOR_"):
+            to_return.append(io_peripheral)
+    
+    return to_return
         
     
 
@@ -98,7 +98,12 @@ void memphis::pes_interconnection(){
 		
 		//EAST GROUNDING
  		if(RouterPosition(i) == BR || RouterPosition(i) == CRX || RouterPosition(i) == TR){
- 			if (io_port[i] != EAST){//If the port in not connected to an IO then:
+ 			//Torus: wraparound link to the WEST port of the first router of the row
+ 			if (TORUS_TOPOLOGY && io_port[i] != EAST && io_port[i-(N_PE_X-1)] != WEST){
+ 				credit_i_ps[i][EAST].write(credit_o_ps[i-(N_PE_X-1)][WEST].read());
+ 				data_in_ps [i][EAST].write(data_out_ps[i-(N_PE_X-1)][WEST].read());
+ 				rx_ps      [i][EAST].write(tx_ps      [i-(N_PE_X-1)][WEST].read());
+ 			} else if (io_port[i] != EAST){//If the port in not connected to an IO then:
 				credit_i_ps[i][EAST].write(0);
 				data_in_ps [i][EAST].write(0);
 				rx_ps      [i][EAST].write(0);
@@ -128,7 +133,12 @@ void memphis::pes_interconnection(){
  		
  		//WEST GROUNDING
  		if(RouterPosition(i) == BL || RouterPosition(i) == CL || RouterPosition(i) == TL){
- 			if (io_port[i] != WEST){
+ 			//Torus: wraparound link to the EAST port of the last router of the row
+ 			if (TORUS_TOPOLOGY && io_port[i] != WEST && io_port[i+(N_PE_X-1)] != EAST){
+ 				credit_i_ps[i][WEST].write(credit_o_ps[i+(N_PE_X-1)][EAST].read());
+ 				data_in_ps [i][WEST].write(data_out_ps[i+(N_PE_X-1)][EAST].read());
+ 				rx_ps      [i][WEST].write(tx_ps      [i+(N_PE_X-1)][EAST].read());
+ 			} else if (io_port[i] != WEST){
 				credit_i_ps[i][WEST].write(0);
 				data_in_ps [i][WEST].write(0);
 				rx_ps      [i][WEST].write(0);
@@ -159,7 +169,12 @@ void memphis::pes_interconnection(){
  		
  		//NORTH GROUNDING
  		if(RouterPosition(i) == TL || RouterPosition(i) == TC || RouterPosition(i) == TR){
- 			if (io_port[i] != NORTH){
+ 			//Torus: wraparound link to the SOUTH port of the first router of the column
+ 			if (TORUS_TOPOLOGY && io_port[i] != NORTH && io_port[i-(N_PE-N_PE_X)] != SOUTH){
+ 				credit_i_ps[i][NORTH].write(credit_o_ps[i-(N_PE-N_PE_X)][SOUTH].read());
+ 				data_in_ps [i][NORTH].write(data_out_ps[i-(N_PE-N_PE_X)][SOUTH].read());
+ 				rx_ps      [i][NORTH].write(tx_ps      [i-(N_PE-N_PE_X)][SOUTH].read());
+ 			} else if (io_port[i] != NORTH){
 				credit_i_ps[i][NORTH].write(1);
 				data_in_ps [i][NORTH].write(0);
 				rx_ps      [i][NORTH].write(0);
@@ -190,7 +205,12 @@ void memphis::pes_interconnection(){
  		
  		//SOUTH GROUNDING
  		if(RouterPosition(i) == BL || RouterPosition(i) == BC || RouterPosition(i) == BR){
- 			if (io_port[i] != SOUTH){
+ 			//Torus: wraparound link to the NORTH port of the last router of the column
+ 			if (TORUS_TOPOLOGY && io_port[i] != SOUTH && io_port[i+(N_PE-N_PE_X)] != NORTH){
+ 				credit_i_ps[i][SOUTH].write(credit_o_ps[i+(N_PE-N_PE_X)][NORTH].read());
+ 				data_in_ps [i][SOUTH].write(data_out_ps[i+(N_PE-N_PE_X)][NORTH].read());
+ 				rx_ps      [i][SOUTH].write(tx_ps      [i+(N_PE-N_PE_X)][NORTH].read());
+ 			} else if (io_port[i] != SOUTH){
 				credit_i_ps[i][SOUTH].write(0);
 				data_in_ps [i][SOUTH].write(0);
 				rx_ps      [i][SOUTH].write(0);
@@ -220,15 +240,17 @@ void memphis::pes_interconnection(){
  		}
 
 		//--IO Wiring (Memphis <-> IO) ----------------------
- 		if (i == APP_INJECTOR && io_port[i] != NPORT) {
- 			p = io_port[i];
-			memphis_app_injector_tx.write(tx_ps[APP_INJECTOR][p].read());
-			memphis_app_injector_data_out.write(data_out_ps[APP_INJECTOR][p].read());
-			credit_i_ps[APP_INJECTOR][p].write(memphis_app_injector_credit_i.read());
-
-			rx_ps[APP_INJECTOR][p].write(memphis_app_injector_rx.read());
-			memphis_app_injector_credit_o.write(credit_o_ps[APP_INJECTOR][p].read());
-			data_in_ps[APP_INJECTOR][p].write(memphis_app_injector_data_in.read());
+ 		for (int a = 0; a < APP_INJECTOR_NUMBER; a++) {
+ 			if (i == app_injector_pe[a] && io_port[i] != NPORT) {
+ 				p = io_port[i];
+				memphis_app_injector_tx[a].write(tx_ps[i][p].read());
+				memphis_app_injector_data_out[a].write(data_out_ps[i][p].read());
+				credit_i_ps[i][p].write(memphis_app_injector_credit_i[a].read());
+
+				rx_ps[i][p].write(memphis_app_injector_rx[a].read());
+				memphis_app_injector_credit_o[a].write(credit_o_ps[i][p].read());
+				data_in_ps[i][p].write(memphis_app_injector_data_in[a].read());
+ 			}
  		}
  		//Insert the IO wiring for your component here if it connected to a NORTH port:
  	}
@@ -33,14 +33,14 @@ SC_MODULE(memphis) {
 	sc_in< bool >			clock;
 	sc_in< bool >			reset;
 
-	//IO interface - App Injector
-	sc_out< bool >			memphis_app_injector_tx;
-	sc_in< bool >			memphis_app_injector_credit_i;
-	sc_out< regflit >		memphis_app_injector_data_out;
+	//IO interface - App Injectors, one per injector declared into the testcase (see app_injector_pe)
+	sc_out< bool >			memphis_app_injector_tx			[APP_INJECTOR_NUMBER];
+	sc_in< bool >			memphis_app_injector_credit_i	[APP_INJECTOR_NUMBER];
+	sc_out< regflit >		memphis_app_injector_data_out	[APP_INJECTOR_NUMBER];
 
-	sc_in< bool >			memphis_app_injector_rx;
-	sc_out< bool >			memphis_app_injector_credit_o;
-	sc_in< regflit >		memphis_app_injector_data_in;
+	sc_in< bool >			memphis_app_injector_rx			[APP_INJECTOR_NUMBER];
+	sc_out< bool >			memphis_app_injector_credit_o	[APP_INJECTOR_NUMBER];
+	sc_in< regflit >		memphis_app_injector_data_in	[APP_INJECTOR_NUMBER];
 
 	//IO interface - Create the IO interface for your component here:
 
@@ -118,12 +118,14 @@ SC_MODULE(memphis) {
 		}
 
 		SC_METHOD(pes_interconnection);
-		sensitive << memphis_app_injector_tx;
-		sensitive << memphis_app_injector_credit_i;
-		sensitive << memphis_app_injector_data_out;
-		sensitive << memphis_app_injector_rx;
-		sensitive << memphis_app_injector_credit_o;
-		sensitive << memphis_app_injector_data_in;
+		for (j = 0; j < APP_INJECTOR_NUMBER; j++) {
+			sensitive << memphis_app_injector_tx		[j];
+			sensitive << memphis_app_injector_credit_i	[j];
+			sensitive << memphis_app_injector_data_out	[j];
+			sensitive << memphis_app_injector_rx		[j];
+			sensitive << memphis_app_injector_credit_o	[j];
+			sensitive << memphis_app_injector_data_in	[j];
+		}
 
 		for (j = 0; j < N_PE; j++) {
 
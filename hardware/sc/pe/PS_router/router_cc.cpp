@@ -223,9 +223,34 @@ void router_cc::upd_clock_tx(){
 			fluxo_5=0;
 			
 			aux=0;
+
+			monitor_window=0;
+			for(int i=0; i<NPORT; i++){
+				link_flits[i]=0;
+				buffer_flits[i]=0;
+				link_utilization[i]=0;
+				buffer_occupancy[i]=0;
+			}
 			
 		}
 		else{
+			//Windowed link utilization and buffer occupancy
+			for(int i=0; i<NPORT; i++){
+				if (tx[i].read() == 1 and credit_i[i].read() == 1)
+					link_flits[i]++;
+				buffer_flits[i] += (myQueue[i]->last.read() - myQueue[i]->first.read()) & (BUFFER_TAM-1);
+			}
+			monitor_window++;
+			if (monitor_window == ROUTER_MONITOR_WINDOW){
+				for(int i=0; i<NPORT; i++){
+					link_utilization[i] = (link_flits[i] * 100) / ROUTER_MONITOR_WINDOW;
+					buffer_occupancy[i] = (buffer_flits[i] * 100) / (ROUTER_MONITOR_WINDOW * BUFFER_TAM);
+					link_flits[i] = 0;
+					buffer_flits[i] = 0;
+				}
+				monitor_window = 0;
+			}
+
 			if((tx[0].read() == 1 and credit_i[0].read() == 1) or (tx[1].read() == 1 and credit_i[1].read() == 1) or (tx[2].read() == 1 and credit_i[2].read() == 1) or
 				(tx[3].read() == 1 and credit_i[3].read() == 1) or (tx[4].read() == 1 and credit_i[4].read() == 1)){
 					
@@ -58,6 +58,13 @@ SC_MODULE(router_cc){
 	unsigned int consumer_id[NPORT];
 	void traffic_monitor();
 
+  //Windowed link and buffer monitors, read by the kernel through the PE performance counters
+	unsigned int monitor_window;
+	unsigned int link_flits[NPORT];
+	unsigned int buffer_flits[NPORT];
+	unsigned int link_utilization[NPORT];	//Output link utilization (%) in the last window
+	unsigned int buffer_occupancy[NPORT];	//Average input buffer occupancy (%) in the last window
+
 
   // interface do Fila
   fila	*myQueue[NPORT];
@@ -107,6 +107,7 @@ void switch_control::controle_sequ(){
 		switch(EA.read()){
 			case S0://Zera variáveis
 				sel.write(0);
+				starvation_count.write(0);
 				
 				ack_h[LOCAL].write(0);
 				ack_h[EAST].write(0);
@@ -138,6 +139,11 @@ void switch_control::controle_sequ(){
 			break;
 			case S2://Seleciona quem tera direito a requisitar roteamento
 				sel.write(prox.read());
+
+				if (priority_grant.read())
+					starvation_count.write(starvation_count.read() + 1);
+				else
+					starvation_count.write(0);
 			break;
 			case S4://Estabelece a conexão com a porta LOCAL
 				mux_in_local.range(sel.read()*3+2,sel.read()*3)=LOCAL;
@@ -196,10 +202,31 @@ void switch_control::controle_sequ(){
 		}
 }
 
+/* Torus dateline rule: the routers have a single virtual channel, so a packet only crosses a wraparound
+ * link (the dateline) when the router at the other side is its target column/row. This breaks the cyclic
+ * channel dependency of each ring. Returns true when such a path is shorter than the mesh path
+ * l - local coordinate, t - target coordinate, n - dimension size, link_free - the wraparound link is not used by an IO peripheral
+ */
+bool switch_control::torus_wrap(int l, int t, int n, bool link_free){
+
+	if (!link_free || l == t)
+		return false;
+
+	if (t == 0)
+		return (n - l) < l; 			//Goes EAST/NORTH up to the edge and crosses the dateline
+
+	if (t == n-1)
+		return (l + 1) < (n - 1 - l); 	//Goes WEST/SOUTH up to the edge and crosses the dateline
+
+	return false;
+}
+
 void switch_control::arbitro_comb(){
 	regmetadeflit header_local;
 	regquartoflit lx_local,ly_local,tx_local,ty_local;
 	sc_uint<3> io_dir_local;
+	bool pending_priority, pending_normal, want_priority, wrap_x, wrap_y;
+	int port, prox_local;
 			
 	if(h[LOCAL].read()==1 || h[EAST].read()==1 || h[WEST].read()==1 || h[NORTH].read()==1 || h[SOUTH].read()==1){
 		ask.write(1);
@@ -209,58 +236,36 @@ void switch_control::arbitro_comb(){
 	}
 	
 
-	switch(sel.read()){
-		case LOCAL:
-				if     (h[EAST ].read()==1) prox.write(EAST);
-				else if(h[WEST ].read()==1) prox.write(WEST);
-				else if(h[NORTH].read()==1) prox.write(NORTH);
-				else if(h[SOUTH].read()==1) prox.write(SOUTH);
-				else                 prox.write(LOCAL);
-				
-				header_local = data[LOCAL].read();
-				io_dir_local = data[LOCAL].read().range(TAM_FLIT-1, TAM_FLIT-3);
-		break;
-		case EAST:
-				if     (h[WEST ].read()==1) prox.write(WEST);
-				else if(h[NORTH].read()==1) prox.write(NORTH);
-				else if(h[SOUTH].read()==1) prox.write(SOUTH);
-				else if(h[LOCAL].read()==1) prox.write(LOCAL);
-				else                 prox.write(EAST);
-				
-				header_local = data[EAST].read();
-				io_dir_local = data[EAST].read().range(TAM_FLIT-1, TAM_FLIT-3);
-		break;
-		case WEST:
-				if     (h[NORTH].read()==1) prox.write(NORTH);
-				else if(h[SOUTH].read()==1) prox.write(SOUTH);
-				else if(h[LOCAL].read()==1) prox.write(LOCAL);
-				else if(h[EAST ].read()==1) prox.write(EAST);
-				else                 prox.write(WEST);
-				
-				header_local = data[WEST].read();
-				io_dir_local = data[WEST].read().range(TAM_FLIT-1, TAM_FLIT-3);
-		break;
-		case NORTH:
-				if     (h[SOUTH].read()==1) prox.write(SOUTH);
-				else if(h[LOCAL].read()==1) prox.write(LOCAL);
-				else if(h[EAST ].read()==1) prox.write(EAST);
-				else if(h[WEST ].read()==1) prox.write(WEST);
-				else                 prox.write(NORTH);
-				
-				header_local = data[NORTH].read();
-				io_dir_local = data[NORTH].read().range(TAM_FLIT-1, TAM_FLIT-3);
-		break;
-		case SOUTH:
-				if     (h[LOCAL].read()==1) prox.write(LOCAL);
-				else if(h[EAST ].read()==1) prox.write(EAST);
-				else if(h[WEST ].read()==1) prox.write(WEST);
-				else if(h[NORTH].read()==1) prox.write(NORTH);
-				else                 prox.write(SOUTH);
-				header_local = data[SOUTH].read();
-				io_dir_local = data[SOUTH].read().range(TAM_FLIT-1, TAM_FLIT-3);
-		break;
+	//Priority-aware round-robin: headers with the PRIORITY_BIT set are served first. After PRIORITY_STARVATION_LIMIT
+	//consecutive priority grants with a best-effort header waiting, the best-effort headers are served once
+	pending_priority = false;
+	pending_normal = false;
+	for(int i=0; i<NPORT; i++){
+		if (h[i].read()==1){
+			if (data[i].read().bit(PRIORITY_BIT)) 	pending_priority = true;
+			else 									pending_normal = true;
+		}
 	}
-		
+
+	want_priority = pending_priority && !(pending_normal && starvation_count.read() == PRIORITY_STARVATION_LIMIT);
+
+	//Visits the ports starting from the one after sel, sel itself is the last one
+	prox_local = sel.read();
+	for(int i=1; i<=NPORT; i++){
+		port = (sel.read() + i) % NPORT;
+		if (h[port].read()==1 && data[port].read().bit(PRIORITY_BIT) == want_priority){
+			prox_local = port;
+			break;
+		}
+	}
+	prox.write(prox_local);
+
+	//Counts only the priority grants that overtake a waiting best-effort header
+	priority_grant.write(want_priority && pending_normal);
+
+	header_local = data[sel.read()].read();
+	io_dir_local = data[sel.read()].read().range(TAM_FLIT-1, TAM_FLIT-3);
+
 	lx_local=address.range((METADEFLIT-1),QUARTOFLIT);
 	ly_local=address.range((QUARTOFLIT-1),0);
 	
@@ -275,8 +280,16 @@ void switch_control::arbitro_comb(){
 	
 	io_dir.write(io_dir_local);
 
+	//Torus: packets to IO peripherals always follow the mesh path
+	wrap_x = false;
+	wrap_y = false;
+	if (TORUS_TOPOLOGY && io_dir_local.bit(2)==0){
+		wrap_x = torus_wrap(lx_local, tx_local, N_PE_X, io_port[ly_local*N_PE_X + N_PE_X-1] != EAST && io_port[ly_local*N_PE_X] != WEST);
+		wrap_y = torus_wrap(ly_local, ty_local, N_PE_Y, io_port[(N_PE_Y-1)*N_PE_X + lx_local] != NORTH && io_port[lx_local] != SOUTH);
+	}
+
 	//if(lx_local > tx_local){ //Old dirx selection, commented due the IO routing implementation
-	if( (lx_local > tx_local) || (io_dir_local.bit(2)==1 && io_dir_local.bit(1)==0 && io_dir_local.bit(0)==1)){
+	if( ((lx_local > tx_local) != wrap_x) || (io_dir_local.bit(2)==1 && io_dir_local.bit(1)==0 && io_dir_local.bit(0)==1)){
 		dirx.write(WEST);
 	}
 	else{
@@ -284,7 +297,7 @@ void switch_control::arbitro_comb(){
 	}
 	
 	//if(ly_local < ty_local){//Old diry selection, commented due the IO routing implementation
-	if( (ly_local < ty_local) || (io_dir_local.bit(2)==1 && io_dir_local.bit(1)==1 && io_dir_local.bit(0)==0)){
+	if( ((ly_local < ty_local) != wrap_y) || (io_dir_local.bit(2)==1 && io_dir_local.bit(1)==1 && io_dir_local.bit(0)==0)){
 		diry.write(NORTH);
 	}
 	else{
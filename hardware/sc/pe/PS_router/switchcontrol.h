@@ -32,6 +32,8 @@ SC_MODULE(switch_control){
 	//sinais do arbitro
 	sc_signal<bool>				ask;
 	sc_signal<sc_uint<4> >		sel, prox;
+	sc_signal<bool>				priority_grant;		//Current arbitration served a priority header while a best-effort one was waiting
+	sc_signal<sc_uint<3> >		starvation_count;	//Consecutive priority grants, bounded by PRIORITY_STARVATION_LIMIT
 
 	//sinais do controle
 	sc_signal<regquartoflit>	dirx,diry;
@@ -51,6 +53,7 @@ SC_MODULE(switch_control){
 	void arbitro_comb();
 	void arbitro_sequ();
 	void state_sequ();
+	bool torus_wrap(int, int, int, bool);
 	
 	//SC_CTOR(switch_control){
 	SC_HAS_PROCESS(switch_control);
@@ -91,6 +94,7 @@ SC_MODULE(switch_control){
 		sensitive << h[SOUTH];
 		sensitive << h[LOCAL];
 		sensitive << sel;
+		sensitive << starvation_count;
 		sensitive << data[EAST];
 		sensitive << data[WEST];
 		sensitive << data[NORTH];
@@ -13,51 +13,98 @@ void dmni_qos::comb_update(){
 	unsigned int count;
 	regSubnet s_active_aux, r_active_aux;
 	regSubnet intr_aux = 0;
+	bool ring_intr_aux = 0;
+	bool fetch_bubble;
+	bool coal_ready;
+	bool stream_aux = 1;
+	bool copy_read;
 
 	s_active_aux = 0;
 	r_active_aux = 0;
 
+	//PS interrupt is released when enough headers were received, the window expired or the FIFO is full.
+	//Inside a packet it is never held, the kernel is reading it
+	coal_ready = !recv_at_header.read() || recv_packets.read() >= coal_packets.read() || coal_timer.read() == 0 || recv_fifo_full.read();
+
+	//Memory read data belongs to a descriptor fetch or to a copy, no subnet is served
+	fetch_bubble = (fetch_state.read() == FETCH_SIZE || fetch_state.read() == FETCH_LOAD || copy_state.read() == COPY_DATA);
+
 	for(int i=0; i<SUBNETS_NUMBER; i++){
 
 		s_valid[i].write( s_wheel[i].read() && s_ready[i].read() && !busy[i].read() );
-		r_valid[i].write( r_wheel[i].read() && r_ready[i].read() && valid_receive[i].read() );
+		r_valid[i].write( r_wheel[i].read() && r_ready[i].read() && valid_receive[i].read() && !copy_full.read() );
 
-		s_wheel[i].write( (s_curr == i) && !dmni_mode.read() && !load_mem.read());
-		r_wheel[i].write( (r_curr == i) && dmni_mode.read());
+		s_wheel[i].write( (s_curr == i) && !fetch_bubble );
+		r_wheel[i].write( r_curr == i );
 
-		s_active_aux[i] = s_ready[i].read();
+		//A subnet with descriptors not yet sent stays active, even between two descriptors
+		s_active_aux[i] = s_ready[i].read() || (ring_size[i].read() != 0 && ring_head[i].read() != ring_done[i].read());
 		r_active_aux[i] = r_ready[i].read();
 
 		//Nao posso estar recebendo nada e valid receive deve ser 1
-		intr_aux[i] = !r_ready[i].read() && valid_receive[i].read();
+		intr_aux[i] = !r_ready[i].read() && valid_receive[i].read() && (i != PS_NET_INDEX || coal_ready);
+
+		ring_intr_aux |= (ring_done[i].read() != ring_ack[i].read());
 
 		s_ready[i].write( !(s_mem_size_reg[i].read() == 0) );
 		r_ready[i].write( !(r_mem_size_reg[i].read() == 0) );
+
+		stream_aux = stream_aux && !s_ready[i].read() && !valid_receive[i].read();
 	}
 
 	intr_subnet.write(intr_aux);
+	ring_intr.write(ring_intr_aux);
+	ring_done_out.write(ring_done[ring_net].read());
+	recv_pending.write(recv_packets.read());
 	send_active.write(s_active_aux);
 	receive_active.write(r_active_aux);
+	copy_active.write(copy_state.read() != COPY_IDLE || copy_full.read());
+	copy_stream.write(stream_aux);
 
+	//The copy takes the read port one cycle out of two, or every cycle while nothing else uses the memory
+	copy_read = (copy_state.read() == COPY_READ && fetch_state.read() == FETCH_IDLE) ||
+				(copy_state.read() == COPY_DATA && stream_aux && copy_size.read() != 0);
 
-	if ( r_valid[r_curr].read() ){
-		mem_data_write.write(data_to_write[r_curr].read());
+
+	//Receive uses the write port, send uses the read port, so both proceed in the same cycle
+	if ( copy_full.read() ){
+		mem_write_address.write( copy_dst.read() );
+		mem_data_write.write(copy_data.read());
 		mem_byte_we.write(0xF);
 	} else {
-		mem_byte_we.write(0);
+		mem_write_address.write( r_mem_address_reg[ r_curr ].read() );
+		if ( r_valid[r_curr].read() ){
+			mem_data_write.write(data_to_write[r_curr].read());
+			mem_byte_we.write(0xF);
+		} else {
+			mem_byte_we.write(0);
+		}
 	}
 
-	if ( dmni_mode.read() == 0 ){
-		mem_address.write( s_mem_address_reg[ s_next ].read() );
+	//The read address is presented one cycle ahead (s_next). When s_next is the subnet being served now,
+	//forwards the address that address_size_process is about to register, so a lone sender streams one word per cycle
+	if ( fetch_state.read() == FETCH_ADDR ){
+		mem_address.write( fetch_ptr.read() );
+	} else if ( fetch_state.read() == FETCH_SIZE ){
+		mem_address.write( fetch_ptr.read() + MEMORY_WORD_SIZE );
+	} else if ( copy_read ){
+		mem_address.write( copy_src.read() );
+	} else if ( s_next == s_curr && !fetch_bubble && s_mem_size_reg[s_curr].read() != 0 && !busy[s_curr].read() ){
+		if ( s_mem_size_reg[s_curr].read() > 1 )
+			mem_address.write( s_mem_address_reg[s_curr].read() + MEMORY_WORD_SIZE );
+		else if ( s_curr == PS_NET_INDEX && mem_size2.read() > 0 )
+			mem_address.write( mem_address2.read() );
+		else
+			mem_address.write( 0 );
 	} else {
-		mem_address.write( r_mem_address_reg[ r_curr ].read() );
+		mem_address.write( s_mem_address_reg[ s_next ].read() );
 	}
 
-	//Count send
+	//Count send - next ready subnet after s_next, s_next itself when it is the only one
 	count = 1;
-	for(int i=2; i<SUBNETS_NUMBER; i++){
+	for(int i=1; i<=SUBNETS_NUMBER; i++){
 		if ( s_ready[ ((s_next + i) % SUBNETS_NUMBER) ].read() ){
-			count = i;
+			count = i % SUBNETS_NUMBER;
 			break;
 		}
 	}
@@ -86,7 +133,28 @@ void dmni_qos::address_size_process(){
 			r_mem_size_reg[i].write(0);
 			mem_address2.write(0);
 			mem_size2.write(0);
+			ring_base[i].write(0);
+			ring_size[i].write(0);
+			ring_head[i].write(0);
+			ring_tail[i].write(0);
+			ring_done[i].write(0);
+			ring_ack[i].write(0);
+			ring_busy[i].write(0);
 		}
+		fetch_state.write(FETCH_IDLE);
+		fetch_net.write(0);
+		fetch_ptr.write(0);
+		fetch_addr.write(0);
+		ring_net.write(0);
+		coal_packets.write(1);
+		coal_window.write(0);
+		coal_timer.write(0);
+		copy_state.write(COPY_IDLE);
+		copy_src.write(0);
+		copy_dst.write(0);
+		copy_size.write(0);
+		copy_data.write(0);
+		copy_full.write(0);
 	} else {
 
 		if (config_valid.read() == 1){
@@ -95,6 +163,7 @@ void dmni_qos::address_size_process(){
 
 				case CODE_NET:
 					cs_net_config = (int) config_data.read();
+					ring_net.write(cs_net_config);
 					break;
 
 				case CODE_OP:
@@ -125,13 +194,134 @@ void dmni_qos::address_size_process(){
 						s_mem_size_reg[cs_net_config].write( config_data.read());
 
 					break;
+
+				//Programming the ring restarts the descriptor counters
+				case CODE_RING_BASE:
+					ring_base[cs_net_config].write(config_data.read());
+					break;
+
+				case CODE_RING_SIZE:
+					ring_size[cs_net_config].write(config_data.read());
+					ring_head[cs_net_config].write(0);
+					ring_tail[cs_net_config].write(0);
+					ring_done[cs_net_config].write(0);
+					ring_ack[cs_net_config].write(0);
+					break;
+
+				case CODE_RING_HEAD:
+					ring_head[cs_net_config].write(config_data.read());
+					break;
+
+				case CODE_RING_ACK:
+					ring_ack[cs_net_config].write(config_data.read());
+					break;
+
+				//packets threshold (bits 31..24, 0 is taken as 1) and window in cycles (bits 23..0)
+				case CODE_RECV_COALESCE:
+					coal_packets.write( (config_data.read().range(31,24) == 0) ? 1 : (unsigned int) config_data.read().range(31,24) );
+					coal_window.write( config_data.read().range(23,0) );
+					break;
+
+				//Writing the size starts the copy, the kernel only programs it while copy_active is 0
+				case CODE_COPY_SRC:
+					copy_src.write(config_data.read());
+					break;
+
+				case CODE_COPY_DST:
+					copy_dst.write(config_data.read());
+					break;
+
+				case CODE_COPY_SIZE:
+					copy_size.write(config_data.read());
+					if (config_data.read() != 0)
+						copy_state.write(COPY_READ);
+					break;
 			}
 		}
 
+		//Coalescing window, starts with the first pending PS header
+		if (recv_packets.read() == 0)
+			coal_timer.write(coal_window.read());
+		else if (coal_timer.read() > 0)
+			coal_timer.write(coal_timer.read() - 1);
+
+		//Descriptor fetch: loads the next descriptor of an idle subnet as a regular send job
+		switch (fetch_state.read()) {
+
+			case FETCH_IDLE:
+				for(int i=0; i<SUBNETS_NUMBER; i++){
+					if (ring_size[i].read() != 0 && ring_head[i].read() != ring_tail[i].read() && s_mem_size_reg[i].read() == 0 && copy_state.read() == COPY_IDLE){
+						fetch_net.write(i);
+						fetch_ptr.write( ring_base[i].read() + (ring_tail[i].read() % ring_size[i].read()) * RING_DESCRIPTOR_SIZE );
+						fetch_state.write(FETCH_ADDR);
+						break;
+					}
+				}
+				break;
+
+			case FETCH_ADDR: //descriptor address word is being read
+				fetch_state.write(FETCH_SIZE);
+				break;
+
+			case FETCH_SIZE: //descriptor size word is being read
+				fetch_addr.write(mem_data_read.read());
+				fetch_state.write(FETCH_LOAD);
+				break;
+
+			case FETCH_LOAD:
+				s_mem_address_reg[fetch_net].write(fetch_addr.read());
+				s_mem_size_reg[fetch_net].write(mem_data_read.read());
+				ring_tail[fetch_net].write(ring_tail[fetch_net].read() + 1);
+				ring_busy[fetch_net].write(1);
+				//A zero sized descriptor is completed without sending
+				if (mem_data_read.read() == 0){
+					ring_done[fetch_net].write(ring_done[fetch_net].read() + 1);
+					ring_busy[fetch_net].write(0);
+				}
+				fetch_state.write(FETCH_IDLE);
+				break;
+		}
+
+		//Memory to memory copy: the word read in the last cycle is written while the next one is read
+		if (copy_full.read() == 1){
+			copy_dst.write(copy_dst.read() + MEMORY_WORD_SIZE);
+			copy_full.write(0);
+		}
+
+		switch (copy_state.read()) {
+
+			case COPY_READ: //source address is presented when no descriptor fetch holds the read port
+				if (fetch_state.read() == FETCH_IDLE){
+					copy_src.write(copy_src.read() + MEMORY_WORD_SIZE);
+					copy_size.write(copy_size.read() - 1);
+					copy_state.write(COPY_DATA);
+				}
+				break;
+
+			case COPY_DATA: //source word is being read
+				copy_data.write(mem_data_read.read());
+				copy_full.write(1);
+				if (copy_size.read() == 0){
+					copy_state.write(COPY_IDLE);
+				} else if (copy_stream.read() == 1){
+					copy_src.write(copy_src.read() + MEMORY_WORD_SIZE);
+					copy_size.write(copy_size.read() - 1);
+				} else {
+					copy_state.write(COPY_READ);
+				}
+				break;
+		}
+
 		//Send address and size update
 		if (s_valid[s_curr].read() == 1){
 
 			if (s_mem_size_reg[s_curr].read() == 1){
+
+				if (ring_busy[s_curr].read() == 1){
+					ring_done[s_curr].write(ring_done[s_curr].read() + 1);
+					ring_busy[s_curr].write(0);
+				}
+
 				if (s_curr == PS_NET_INDEX && mem_size2.read() > 0){
 
 					s_mem_address_reg[s_curr].write(mem_address2.read());
@@ -179,42 +369,3 @@ void dmni_qos::TDM_wheel_process(){
 		r_curr =  (r_curr + r_next_count) % SUBNETS_NUMBER;
 	}
 }
-
-void dmni_qos::arbiter_process(){
-	bool s_ready_all, r_ready_all;
-
-	if (reset.read() == 1){
-		dmni_mode.write(0); //init in send mode
-		timer.write(0);
-	} else {
-
-		timer.write(timer.read() + 1);
-
-		if (dmni_mode.read() == 0)
-			load_mem.write(0);
-		else
-			load_mem.write(1);
-
-		if (timer.read() == 0){
-
-			s_ready_all = 0;
-			r_ready_all = 0;
-
-			for(int i=0; i<SUBNETS_NUMBER; i++){
-				s_ready_all |= s_ready[i].read();
-				r_ready_all |= r_ready[i].read();
-			}
-
-			if (s_ready_all != 0 && r_ready_all != 0){
-				dmni_mode.write(!dmni_mode.read());
-			} else if (r_ready_all != 0){
-				dmni_mode.write(1);
-			} else {
-				dmni_mode.write(0);
-			}
-
-		}
-	}
-}
-
-
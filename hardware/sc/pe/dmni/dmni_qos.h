@@ -23,18 +23,23 @@ SC_MODULE(dmni_qos){
 
 	//Configuration interface
 	sc_in <bool > 			config_valid;
-	sc_in <sc_uint<3> > 	config_code;
+	sc_in <sc_uint<4> > 	config_code;
 	sc_in <reg32>			config_data;
 
 	//Status interface
 	sc_out<regSubnet >		intr_subnet;
 	sc_out<regSubnet >		send_active;
 	sc_out<regSubnet >		receive_active;
+	sc_out<bool >			ring_intr;
+	sc_out<reg32 >			ring_done_out;		//ring_done of the subnet selected by CODE_NET
+	sc_out<reg8 >			recv_pending;		//PS packets stored into the receive FIFO
+	sc_out<bool >			copy_active;		//memory to memory copy not finished
 
-	//Memory interface
+	//Memory interface - send reads through mem_address and receive writes through mem_write_address, both in the same cycle
 	sc_out<reg32 >			mem_address;
-	sc_out<reg32 >			mem_data_write;
 	sc_in<reg32 >			mem_data_read;
+	sc_out<reg32 >			mem_write_address;
+	sc_out<reg32 >			mem_data_write;
 	sc_out<reg4 >			mem_byte_we;
 
 	//NoC CS Interface (Local port)
@@ -72,9 +77,43 @@ SC_MODULE(dmni_qos){
 	sc_signal<reg32> 		mem_address2;
 	sc_signal<reg32> 		mem_size2;
 
+	//send descriptor ring, head/tail/done/ack are free running descriptor counters
+	sc_signal<reg32> 		ring_base			[SUBNETS_NUMBER];
+	sc_signal<reg32> 		ring_size			[SUBNETS_NUMBER];	//number of descriptors, 0 disables the ring
+	sc_signal<reg32> 		ring_head			[SUBNETS_NUMBER];	//written by the kernel
+	sc_signal<reg32> 		ring_tail			[SUBNETS_NUMBER];	//descriptors fetched
+	sc_signal<reg32> 		ring_done			[SUBNETS_NUMBER];	//descriptors completely sent
+	sc_signal<reg32> 		ring_ack			[SUBNETS_NUMBER];	//completions handled by the kernel
+	sc_signal<bool > 		ring_busy			[SUBNETS_NUMBER];	//current send job was loaded from the ring
+
+	//descriptor fetch, uses the memory read port during 2 cycles and blocks the send wheel while the words return
+	enum fetch_fsm {FETCH_IDLE, FETCH_ADDR, FETCH_SIZE, FETCH_LOAD};
+	sc_signal<sc_uint<2> >	fetch_state;
+	sc_signal<int>			fetch_net;
+	sc_signal<reg32>		fetch_ptr;
+	sc_signal<reg32>		fetch_addr;
+	sc_signal<int>			ring_net;			//copy of cs_net_config used by the combinational status read
+
+	//PS receive interrupt coalescing: the interrupt waits for coal_packets headers or coal_window cycles
+	sc_signal<reg8 >		recv_packets;
+	sc_signal<bool >		recv_at_header;
+	sc_signal<bool >		recv_fifo_full;
+	sc_signal<reg8 >		coal_packets;
+	sc_signal<reg32 >		coal_window;
+	sc_signal<reg32 >		coal_timer;
+
+	//memory to memory copy (local message delivery), shares the read port with send and the write port with receive
+	enum copy_fsm {COPY_IDLE, COPY_READ, COPY_DATA};
+	sc_signal<sc_uint<2> >	copy_state;
+	sc_signal<reg32>		copy_src;
+	sc_signal<reg32>		copy_dst;
+	sc_signal<reg32>		copy_size;			//words not read yet
+	sc_signal<reg32>		copy_data;
+	sc_signal<bool >		copy_full;			//copy_data waits the write port, it has priority over the receive
+	sc_signal<bool >		copy_stream;		//send and receive are idle, the copy reads one word per cycle
+
 	//auxiliary
 	sc_signal<bool>			code_config;
-	sc_signal<bool>			load_mem;
 	int 					cs_net_config;
 
 	//combinational TDM wheel control
@@ -84,10 +123,6 @@ SC_MODULE(dmni_qos){
 	sc_signal<bool >		s_wheel[SUBNETS_NUMBER];
 	sc_signal<bool >		r_wheel[SUBNETS_NUMBER];
 
-	//Send and Receive Arbiter
-	sc_signal<bool>			dmni_mode;
-	sc_signal<reg4>			timer;
-
 	//Instances
 	noc_cs_sender	* 	noc_CS_sender	[CS_SUBNETS_NUMBER];
 	noc_cs_receiver * 	noc_CS_receiver	[CS_SUBNETS_NUMBER];
@@ -103,7 +138,6 @@ SC_MODULE(dmni_qos){
 	//Sequential
 	void address_size_process();
 	void TDM_wheel_process();
-	void arbiter_process();
 
 	SC_HAS_PROCESS(dmni_qos);
 	dmni_qos (sc_module_name name_, int pe_addr_) : sc_module(name_), pe_addr(pe_addr_) {
@@ -162,13 +196,24 @@ SC_MODULE(dmni_qos){
 				noc_PS_receiver->rx(rx_ps);
 				noc_PS_receiver->data_in(data_in_ps);
 				noc_PS_receiver->credit_out(credit_out_ps);
+				noc_PS_receiver->packets(recv_packets);
+				noc_PS_receiver->at_header(recv_at_header);
+				noc_PS_receiver->fifo_full(recv_fifo_full);
 			}
 		}
 
 		//Combinational
 		SC_METHOD(comb_update);
-		sensitive << dmni_mode;
+		sensitive << mem_address2 << mem_size2;
+		sensitive << fetch_state << fetch_ptr << ring_net;
+		sensitive << recv_packets << recv_at_header << recv_fifo_full;
+		sensitive << coal_packets << coal_timer;
+		sensitive << copy_state << copy_src << copy_dst << copy_size << copy_data << copy_full;
 		for (int i = 0; i < SUBNETS_NUMBER; i++){
+			sensitive << ring_size[i];
+			sensitive << ring_head[i];
+			sensitive << ring_done[i];
+			sensitive << ring_ack[i];
 			sensitive << s_wheel[i];
 			sensitive << r_wheel[i];
 			sensitive << s_ready[i];
@@ -194,10 +239,6 @@ SC_MODULE(dmni_qos){
 		SC_METHOD(TDM_wheel_process);
 		sensitive << clock.pos();
 		sensitive << reset;
-
-		SC_METHOD(arbiter_process);
-		sensitive << clock.pos();
-		sensitive << reset;
 	}
 	public:
 		int pe_addr;
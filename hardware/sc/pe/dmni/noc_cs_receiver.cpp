@@ -21,7 +21,11 @@ void noc_cs_receiver::sequential(){
 		//reads from noc
 		if (rx.read() == 1 && full[tail.read()].read() == 0 ){
 
+#if TAM_CS_FLIT == 32
+			data[tail.read()].write( data_in.read() );
+#else
 			data[tail.read()].write( ( data_in, data[tail.read()].read().range(31, TAM_CS_FLIT) ) );
+#endif
 
 			shifter_count.write(shifter_count.read() - 1);
 
@@ -7,36 +7,69 @@
 
 #include "noc_ps_receiver.h"
 
+//Advances the framing FSM of one side of the FIFO with the flit that crosses it
+void noc_ps_receiver::frame_step(sc_signal<sc_uint<2> > & state, sc_signal<reg32 > & remaining, reg32 flit){
+
+	switch (state.read()) {
+		case F_HEADER:
+			state.write(F_SIZE);
+			break;
+		case F_SIZE:
+			remaining.write(flit);
+			state.write( (flit == 0) ? F_HEADER : F_PAYLOAD );
+			break;
+		default:
+			if (remaining.read() == 1)
+				state.write(F_HEADER);
+			remaining.write(remaining.read() - 1);
+			break;
+	}
+}
+
 void noc_ps_receiver::sequential(){
 
+	bool push, pop;
+
 	if (reset == 1) {
 		tail.write(0);
 		head.write(0);
-		full[0].write(0);
-		full[1].write(0);
-		data[0].write(0);
-		data[1].write(0);
+		count.write(0);
+		in_frame.write(F_HEADER);
+		out_frame.write(F_HEADER);
+		in_remaining.write(0);
+		out_remaining.write(0);
+		packets_reg.write(0);
+		for (int i = 0; i < PS_RECV_BUFFER; i++)
+			data[i].write(0);
 	} else {
+
+		push = (rx.read() == 1 && count.read() < PS_RECV_BUFFER);
+		pop = (consume.read() == 1 && count.read() > 0);
+
 		//reads from noc
-		if (rx.read() == 1 && full[tail.read()].read() == 0 ){
+		if (push){
 			data[tail.read()].write( data_in.read() );
-			full[tail.read()].write(1);
-			tail.write(!tail.read());
+			tail.write( (tail.read() + 1) % PS_RECV_BUFFER );
+			frame_step(in_frame, in_remaining, data_in.read());
 		}
 
 		//writes to memory
-		if (consume.read() == 1 && full[head.read()].read() == 1){
-			full[head.read()].write(0);
-			head.write(!head.read());
+		if (pop){
+			head.write( (head.read() + 1) % PS_RECV_BUFFER );
+			frame_step(out_frame, out_remaining, data[head.read()].read());
 		}
+
+		count.write( count.read() + push - pop );
+		packets_reg.write( packets_reg.read() + (push && in_frame.read() == F_HEADER) - (pop && out_frame.read() == F_HEADER) );
 	}
 }
 
 void noc_ps_receiver::combinational(){
-	credit_out.write( !full[0].read() || !full[1].read() );
-	valid.write( full[0].read() || full[1].read() );
+	credit_out.write( count.read() < PS_RECV_BUFFER );
+	valid.write( count.read() > 0 );
 	data_to_memory.write( data[head.read()].read() );
-}
-
-
 
+	packets.write( packets_reg.read() );
+	at_header.write( out_frame.read() == F_HEADER );
+	fifo_full.write( count.read() == PS_RECV_BUFFER );
+}
@@ -21,14 +21,26 @@ SC_MODULE(noc_ps_receiver){
 	sc_out<bool > 		valid;
 	sc_in <bool > 		consume;
 
+	//Receive FIFO status, used by the interrupt coalescing
+	sc_out<reg8 > 		packets;		//headers stored into the FIFO and not consumed yet
+	sc_out<bool > 		at_header;		//next consumed flit is a packet header
+	sc_out<bool > 		fifo_full;
+
 	sc_in <bool > 		rx;
 	sc_in<regflit > 	data_in;
 	sc_out<bool > 		credit_out;
 
 	//Signals
-	sc_signal<reg32 >	data[2];
-	sc_signal<bool >	full[2];
-	sc_signal<bool > 	head, tail;
+	sc_signal<reg32 >	data[PS_RECV_BUFFER];
+	sc_signal<int > 	head, tail, count;
+
+	//Packet framing of the input and output sides of the FIFO: header, size, payload
+	enum frame {F_HEADER, F_SIZE, F_PAYLOAD};
+	sc_signal<sc_uint<2> >	in_frame, out_frame;
+	sc_signal<reg32 > 	in_remaining, out_remaining;
+	sc_signal<reg8 > 	packets_reg;
+
+	void frame_step(sc_signal<sc_uint<2> > &, sc_signal<reg32 > &, reg32);
 
 	void combinational();
 	void sequential();
@@ -37,9 +49,10 @@ SC_MODULE(noc_ps_receiver){
 	noc_ps_receiver (sc_module_name name_) : sc_module(name_) {
 
 		SC_METHOD(combinational);
-		sensitive << full[0] << full[1];
-		sensitive << data[0] << data[1];
-		sensitive << head;
+		sensitive << head << count;
+		sensitive << out_frame << packets_reg;
+		for (int i = 0; i < PS_RECV_BUFFER; i++)
+			sensitive << data[i];
 
 		SC_METHOD(sequential);
 		sensitive << clock.pos();
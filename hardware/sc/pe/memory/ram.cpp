@@ -104,7 +104,7 @@ void ram::write_a() {
 }
 
 
-/*** Memory read port B ***/
+/*** Memory read port B - DMNI send ***/
 void ram::read_b() {
 
 	unsigned int address;
@@ -116,14 +116,14 @@ void ram::read_b() {
 }
 
 
-/*** Memory write port B ***/
-void ram::write_b() {
+/*** Memory write port C - DMNI receive ***/
+void ram::write_c() {
 
 	unsigned int data, address;
 	unsigned char wbe;
 
-	wbe = (unsigned char)wbe_b.read();
-	address = (unsigned int)address_b.read();
+	wbe = (unsigned char)wbe_c.read();
+	address = (unsigned int)address_c.read();
 
 
 	if ( wbe != 0 && address < RAM_SIZE) {
@@ -131,31 +131,31 @@ void ram::write_b() {
 
 		switch(wbe) {
 			case 0xF:	// Write word
-				ram_data[address] = data_write_b.read();
+				ram_data[address] = data_write_c.read();
 			break;
 
 			case 0xC:	// Write MSW
-				ram_data[address] = (data & ~half_word[1]) | (data_write_b.read() & half_word[1]);
+				ram_data[address] = (data & ~half_word[1]) | (data_write_c.read() & half_word[1]);
 			break;
 
 			case 3:		// Write LSW
-				ram_data[address] = (data & ~half_word[0]) | (data_write_b.read() & half_word[0]);
+				ram_data[address] = (data & ~half_word[0]) | (data_write_c.read() & half_word[0]);
 			break;
 
 			case 8:		// Write byte 3
-				ram_data[address] = (data & ~byte[3]) | (data_write_b.read() & byte[3]);
+				ram_data[address] = (data & ~byte[3]) | (data_write_c.read() & byte[3]);
 			break;
 
 			case 4:		// Write byte 2
-				ram_data[address] = (data & ~byte[2]) | (data_write_b.read() & byte[2]);
+				ram_data[address] = (data & ~byte[2]) | (data_write_c.read() & byte[2]);
 			break;
 
 			case 2:		// Write byte 1
-				ram_data[address] = (data & ~byte[1]) | (data_write_b.read() & byte[1]);
+				ram_data[address] = (data & ~byte[1]) | (data_write_c.read() & byte[1]);
 			break;
 
 			case 1:		// Write byte 0
-				ram_data[address] = (data & ~byte[0]) | (data_write_b.read() & byte[0]);
+				ram_data[address] = (data & ~byte[0]) | (data_write_c.read() & byte[0]);
 			break;
 		}
 	}
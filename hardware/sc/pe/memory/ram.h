@@ -18,12 +18,16 @@ SC_MODULE(ram) {
 	sc_in < sc_uint<32> >	data_write_a;
 	sc_out < sc_uint<32> >	data_read_a;
 
+	//Port B is read only (DMNI send) and port C is write only (DMNI receive), allowing the DMNI to send and receive in the same cycle
 	sc_in< sc_uint<30> >	address_b;
 	sc_in< bool >			enable_b;
-	sc_in < sc_uint<4> >	wbe_b;
-	sc_in < sc_uint<32> >	data_write_b;
 	sc_out < sc_uint<32> >	data_read_b;
 
+	sc_in< sc_uint<30> >	address_c;
+	sc_in< bool >			enable_c;
+	sc_in < sc_uint<4> >	wbe_c;
+	sc_in < sc_uint<32> >	data_write_c;
+
 	unsigned long ram_data[RAM_SIZE];
 	unsigned long byte[4];
 	unsigned long half_word[2];
@@ -33,7 +37,8 @@ SC_MODULE(ram) {
 	void write_a();
 
 	void read_b();
-	void write_b();
+
+	void write_c();
 
 	void load_ram();
 
@@ -51,7 +56,7 @@ SC_MODULE(ram) {
 		SC_METHOD(read_b);
 		sensitive << clk.pos();
 
-		SC_METHOD(write_b);
+		SC_METHOD(write_c);
 		sensitive << clk.pos();
 
 		// Byte masks.
@@ -0,0 +1,166 @@
+#include "msg_request_table.h"
+
+bool msg_request_table::is_local(unsigned int task_id){
+
+	for(int i=0; i<MSG_REQUEST_TABLE_TASKS; i++){
+		if (local_task[i] == task_id)
+			return true;
+	}
+	return false;
+}
+
+//Searches an entry according to mode and removes it from the table, the entry is kept at result and result_tasks
+void msg_request_table::match(int mode, unsigned int key){
+
+	bool found;
+
+	for(int i=0; i<MSG_REQUEST_TABLE_SIZE; i++){
+
+		if (!entry_valid[i])
+			continue;
+
+		switch (mode) {
+			case MATCH_EXACT:
+				found = (entry_producer[i] == (key >> 16)) && (entry_consumer[i] == (key & 0xFFFF));
+				break;
+			case MATCH_PRODUCER:
+				found = (entry_producer[i] == (key & 0xFFFF));
+				break;
+			default: //MATCH_ORPHAN
+				found = !is_local(entry_producer[i]);
+				break;
+		}
+
+		if (found){
+			entry_valid[i] = false;
+			result.write(entry_requester[i]);
+			result_tasks.write((entry_producer[i] << 16) | entry_consumer[i]);
+			return;
+		}
+	}
+
+	result.write(0xFFFFFFFF);
+	result_tasks.write(0xFFFFFFFF);
+}
+
+void msg_request_table::insert(){
+
+	FILE *fp;
+	char aux[255];
+
+	for(int i=0; i<MSG_REQUEST_TABLE_SIZE; i++){
+		if (!entry_valid[i]){
+			entry_valid[i] = true;
+			entry_producer[i] = producer.read();
+			entry_consumer[i] = consumer.read();
+			entry_requester[i] = requester_proc.read();
+
+			//Same report written by the kernel through ADD_REQUEST_DEBUG, used by the HeMPS Debugger Tool
+			sprintf(aux, "debug/request/%d.txt", (unsigned int)router_address);
+			fp = fopen (aux, "a");
+			sprintf(aux, "add\t%d\t%d\t%d\n", (unsigned int)producer.read(), (unsigned int)consumer.read(), (unsigned int)tick_counter.read());
+			fprintf(fp,"%s",aux);
+			fclose (fp);
+			return;
+		}
+	}
+}
+
+void msg_request_table::process(){
+
+	int 	free_entries;
+	bool 	orphan;
+
+	if (reset.read()) {
+		absorbing.write(0);
+		cfg_packet.write(0);
+		has_room.write(1);
+		intr.write(0);
+		result.write(0xFFFFFFFF);
+		result_tasks.write(0xFFFFFFFF);
+		PS.write(header);
+		for(int i=0; i<MSG_REQUEST_TABLE_SIZE; i++)
+			entry_valid[i] = false;
+		for(int i=0; i<MSG_REQUEST_TABLE_TASKS; i++)
+			local_task[i] = MSG_REQUEST_FREE_TASK;
+	} else {
+
+		//Kernel commands
+		if (cpu_write.read()) {
+			switch (cpu_address.read()) {
+				case MSG_REQUEST_TASK:
+					local_task[cpu_data.read().range(31,16) % MSG_REQUEST_TABLE_TASKS] = cpu_data.read().range(15,0);
+					break;
+				case MSG_REQUEST_MATCH:
+					match(MATCH_EXACT, cpu_data.read());
+					break;
+				case MSG_REQUEST_MATCH_PRODUCER:
+					match(MATCH_PRODUCER, cpu_data.read());
+					break;
+				case MSG_REQUEST_MATCH_ORPHAN:
+					match(MATCH_ORPHAN, cpu_data.read());
+					break;
+			}
+		}
+
+		//Local port snoop
+		if (rx.read() && credit_o.read()) {
+
+			switch (PS.read()) {
+				case header:
+					absorbing.write( MSG_REQUEST_TABLE && data_in.read().range(MSG_REQUEST_BIT, MSG_REQUEST_BIT) && has_room.read() );
+					cfg_packet.write( data_in.read().range(16, 16) );
+					PS.write(p_size);
+					break;
+
+				case p_size:
+					//CS config packets have a single config flit, see CS_config
+					if (cfg_packet.read())
+						payload.write(1);
+					else
+						payload.write(data_in.read());
+					flit_index.write(2);
+					PS.write(ppayload);
+					break;
+
+				case ppayload:
+					switch (flit_index.read()) {
+						case 3: producer.write(data_in.read().range(15,0)); 	break;
+						case 4: consumer.write(data_in.read().range(15,0)); 	break;
+						case 8: requester_proc.write(data_in.read()); 			break;
+					}
+					if (flit_index.read() < 15)
+						flit_index.write(flit_index.read() + 1);
+
+					if (payload.read() == 1) {
+						if (absorbing.read())
+							insert();
+						absorbing.write(0);
+						PS.write(header);
+					}
+					payload.write(payload.read() - 1);
+					break;
+			}
+		}
+
+		free_entries = 0;
+		orphan = false;
+		for(int i=0; i<MSG_REQUEST_TABLE_SIZE; i++){
+			if (entry_valid[i])
+				orphan = orphan || !is_local(entry_producer[i]);
+			else
+				free_entries++;
+		}
+		has_room.write(free_entries > 0);
+		intr.write(orphan);
+	}
+}
+
+void msg_request_table::comb_update(){
+
+	bool new_request;
+
+	new_request = MSG_REQUEST_TABLE && (PS.read() == header) && rx.read() && data_in.read().range(MSG_REQUEST_BIT, MSG_REQUEST_BIT) && has_room.read();
+
+	absorb.write( new_request || absorbing.read() );
+}
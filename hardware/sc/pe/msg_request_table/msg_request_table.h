@@ -0,0 +1,81 @@
+#ifndef _MSG_REQUEST_TABLE_H
+#define _MSG_REQUEST_TABLE_H
+
+#include <systemc.h>
+#include "../../standards.h"
+
+//Hardware message request table. It snoops the PS local port and absorbs the MESSAGE_REQUEST packets
+//flagged with MSG_REQUEST_BIT, storing (producer, consumer, requester_proc) in a small CAM.
+//The kernel matches the Send() against the CAM through memory mapped registers, so a request
+//addressed to a local producer does not interrupt the CPU. Requests to a producer that is not
+//registered as local (e.g., migrated) are signaled by intr to be forwarded by the kernel.
+SC_MODULE(msg_request_table){
+
+	// ports
+	sc_in<bool> 	clock;
+	sc_in<bool> 	reset;
+
+	//Local port snoop
+	sc_in<bool> 	rx;
+	sc_in<regflit> 	data_in;
+	sc_in<bool> 	credit_o;
+
+	sc_out<bool> 	absorb;		//Masks the packet to the DMNI
+
+	//CPU interface
+	sc_in<reg32>	cpu_address;
+	sc_in<reg32>	cpu_data;
+	sc_in<bool>		cpu_write;
+
+	sc_out<reg32>	result;			//requester_proc of the last matched entry, 0xFFFFFFFF if not found
+	sc_out<reg32>	result_tasks;	//producer << 16 | consumer of the last matched entry
+	sc_out<bool>	intr;			//There is a stored request to a non local producer
+
+	sc_in<reg32>	tick_counter;
+
+	//Signals
+	sc_signal<bool> 	absorbing;
+	sc_signal<bool> 	has_room;
+	sc_signal<bool> 	cfg_packet;
+	sc_signal<regflit> 	payload;
+	sc_signal<reg4> 	flit_index;
+	sc_signal<reg16> 	producer;
+	sc_signal<reg16> 	consumer;
+	sc_signal<reg32> 	requester_proc;
+
+	enum state {header,p_size,ppayload};
+	sc_signal<state >		PS;
+
+	//Table
+	bool 			entry_valid		[MSG_REQUEST_TABLE_SIZE];
+	unsigned int	entry_producer	[MSG_REQUEST_TABLE_SIZE];
+	unsigned int	entry_consumer	[MSG_REQUEST_TABLE_SIZE];
+	unsigned int	entry_requester	[MSG_REQUEST_TABLE_SIZE];
+
+	//Local producers, indexed by the kernel TCB index
+	unsigned int	local_task		[MSG_REQUEST_TABLE_TASKS];
+
+	void process();
+	void comb_update();
+
+	bool is_local(unsigned int task_id);
+	void match(int mode, unsigned int key);
+	void insert();
+
+	SC_HAS_PROCESS(msg_request_table);
+	msg_request_table (sc_module_name name_, regaddress address_ = 0x00) : sc_module(name_), router_address(address_) {
+
+	   SC_METHOD(process);
+	   sensitive << reset;
+	   sensitive << clock.pos();
+
+	   SC_METHOD(comb_update);
+	   sensitive << rx << data_in;
+	   sensitive << PS << absorbing << has_room;
+	}
+
+	public:
+		regaddress router_address;
+};
+
+#endif
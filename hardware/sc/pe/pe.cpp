@@ -40,9 +40,30 @@ void pe::mem_mapped_registers(){
 		case DMNI_RECEIVE_ACTIVE:
 			cpu_mem_data_read.write(dmni_receive_active.read());
 		break;
+		case DMNI_COPY_ACTIVE:
+			cpu_mem_data_read.write(dmni_copy_active.read());
+		break;
 		case READ_CS_REQUEST:
 			cpu_mem_data_read.write(req_in_reg.read());
 			break;
+		case DMNI_RING_DONE:
+			cpu_mem_data_read.write(dmni_ring_done.read());
+			break;
+		case DMNI_RECV_PENDING:
+			cpu_mem_data_read.write(dmni_recv_pending.read());
+			break;
+		case MSG_REQUEST_RESULT:
+			cpu_mem_data_read.write(msg_req_result.read());
+			break;
+		case MSG_REQUEST_RESULT_TASKS:
+			cpu_mem_data_read.write(msg_req_result_tasks.read());
+			break;
+		case PERF_VALUE:
+			cpu_mem_data_read.write(perf_value());
+			break;
+		case DVFS_LEVEL:
+			cpu_mem_data_read.write(dvfs_level.read());
+			break;
 		default:
 			cpu_mem_data_read.write(data_read_ram.read());
 		break;
@@ -69,10 +90,13 @@ void pe::comb_assignments(){
 
 	addr_a.write(new_mem_address.range(31, 2));
 	addr_b.write(dmni_mem_address.read()(31,2));
+	addr_c.write(dmni_mem_write_address.read()(31,2));
 
 	cpu_mem_pause.write(0);
 	irq.write((((irq_status.read() & irq_mask_reg.read()) != 0x00)) ? 1  : 0 );
 	dmni_mem_data_read.write(mem_data_read.read());
+	//One PE cycle strobe at any DVFS level: the byte enable register is cleared at the cycles skipped by the CPU clock,
+	//while cpu_mem_address_reg stays held. Side-effecting MMIO writes are decoded with write_enable, never by the address alone
 	write_enable.write(((cpu_mem_write_byte_enable_reg.read() != 0)) ? 1  : 0 );
 	cpu_enable_ram.write(1);
 	dmni_enable_internal_ram.write(1);
@@ -83,6 +107,10 @@ void pe::comb_assignments(){
 	for(int i=0; i<SUBNETS_NUMBER; i++){
 		l_irq_status[i+4] = dmni_intr.read().range(i,i);
 	}
+	//DMNI send ring completion
+	l_irq_status[IRQ_DMNI_RING_BIT] = dmni_ring_intr.read();
+	//Message request table, request to a non local producer
+	l_irq_status[IRQ_MSG_REQUEST_BIT] = msg_req_intr.read();
 	//CS req
 	l_irq_status[3] = ( req_in_reg.read() != 0) ? 1 : 0;
 	//Slack time updater
@@ -111,9 +139,13 @@ void pe::comb_assignments(){
 		}
 	}
 
-	//Used to mask the packet to DMNI when it is designated to configure a CS router
-	dmni_rec_en.write( !( (data_in_dmni_ps.read().range(16,16) && config_wait_header.read()) || config_en.read() ) );
+	//Used to mask the packet to DMNI when it is designated to configure a CS router or it is absorbed by the message request table
+	dmni_rec_en.write( !( (data_in_dmni_ps.read().range(16,16) && config_wait_header.read()) || config_en.read() || msg_req_absorb.read() ) );
+#if TRAFFIC_GENERATOR
+	rx_dmni_ps.write(0);
+#else
 	rx_dmni_ps.write( dmni_rec_en.read() && tx_router_local_ps.read() );
+#endif
 
 	//DMNI config
 	switch (cpu_mem_address_reg.read()) {
@@ -123,13 +155,21 @@ void pe::comb_assignments(){
 		case DMNI_MEM_ADDR2:cpu_code_dmni.write(CODE_MEM_ADDR2);break;
 		case DMNI_MEM_SIZE2:cpu_code_dmni.write(CODE_MEM_SIZE2);break;
 		case DMNI_OP: 		cpu_code_dmni.write(CODE_OP); 		break;
+		case DMNI_RING_BASE:cpu_code_dmni.write(CODE_RING_BASE);break;
+		case DMNI_RING_SIZE:cpu_code_dmni.write(CODE_RING_SIZE);break;
+		case DMNI_RING_HEAD:cpu_code_dmni.write(CODE_RING_HEAD);break;
+		case DMNI_RING_ACK:	cpu_code_dmni.write(CODE_RING_ACK); break;
+		case DMNI_RECV_COALESCE:cpu_code_dmni.write(CODE_RECV_COALESCE);break;
+		case DMNI_COPY_SRC:	cpu_code_dmni.write(CODE_COPY_SRC); break;
+		case DMNI_COPY_DST:	cpu_code_dmni.write(CODE_COPY_DST); break;
+		case DMNI_COPY_SIZE:cpu_code_dmni.write(CODE_COPY_SIZE);break;
 		default: 		  	cpu_code_dmni.write(0); 			break;
 	}
-	cpu_valid_dmni.write( (cpu_code_dmni.read() == 0 ? 0 : 1) );
+	cpu_valid_dmni.write( (cpu_code_dmni.read() != 0 && write_enable.read() == 1) ? 1 : 0 );
 
 	//************** request update *******************
 	if (cpu_mem_address_reg.read() == HANDLE_CS_REQUEST && write_enable.read() == 1)
-		handle_req.write( cpu_mem_data_write_reg.read().range(CS_SUBNETS_NUMBER, 0) );
+		handle_req.write( cpu_mem_data_write_reg.read().range(CS_SUBNETS_NUMBER-1, 0) );
 	else
 		handle_req.write(0);
 
@@ -157,6 +197,38 @@ void pe::memory_mux(){
 }
 */
 
+unsigned int pe::perf_value(){
+	unsigned int index = perf_select.read().range(7,0);
+
+	switch(perf_select.read().range(15,8)){
+		case PERF_INSTRUCTIONS:
+			if (index < PERF_PAGES) return (unsigned int) cpu->page_inst[index];
+			break;
+		case PERF_CYCLES:
+			if (index < PERF_PAGES) return (unsigned int) perf_cycles[index];
+			break;
+		case PERF_STALLS:
+			if (index < PERF_PAGES) return (unsigned int) perf_stalls[index];
+			break;
+		case PERF_INTERRUPTS:
+			if (index < PERF_PAGES) return (unsigned int) cpu->page_intr[index];
+			break;
+		case PERF_DMNI_SENT:
+			if (index < SUBNETS_NUMBER) return (unsigned int) perf_sent[index];
+			break;
+		case PERF_DMNI_RECEIVED:
+			if (index < SUBNETS_NUMBER) return (unsigned int) perf_received[index];
+			break;
+		case PERF_LINK_UTILIZATION:
+			if (index < NPORT) return ps_router->link_utilization[index];
+			break;
+		case PERF_BUFFER_OCCUPANCY:
+			if (index < NPORT) return ps_router->buffer_occupancy[index];
+			break;
+	}
+	return 0;
+}
+
 void pe::reset_n_attr(){
 	reset_n.write(!reset.read());
 }
@@ -177,6 +249,22 @@ void pe::sequential_attr(){
 		pending_service.write(0);
 		slack_update_timer.write(0);
 		req_in_reg.write(0);
+		perf_select.write(0);
+		for(int i=0; i<PERF_PAGES; i++){
+			perf_cycles[i] = 0;
+			perf_stalls[i] = 0;
+		}
+		for(int i=0; i<SUBNETS_NUMBER; i++){
+			perf_sent[i] = 0;
+			perf_received[i] = 0;
+		}
+		dvfs_level.write(0);
+		for(int i=0; i<DVFS_LEVELS; i++){
+			dvfs_cycles[i] = 0;
+			dvfs_cpu_cycles[i] = 0;
+			dvfs_inst[i] = 0;
+		}
+		dvfs_last_inst = cpu->global_inst;
 	} else {
 
 		//************** req_in_reg *******************
@@ -187,11 +275,16 @@ void pe::sequential_attr(){
 		//*********************************************
 
 		if(cpu_mem_pause.read() == 0) {
-			cpu_mem_address_reg.write(cpu_mem_address.read());
+			if (dvfs_tick.read() == 1){
+				cpu_mem_address_reg.write(cpu_mem_address.read());
 
-			cpu_mem_data_write_reg.write(cpu_mem_data_write.read());
+				cpu_mem_data_write_reg.write(cpu_mem_data_write.read());
 
-			cpu_mem_write_byte_enable_reg.write(cpu_mem_write_byte_enable.read());
+				cpu_mem_write_byte_enable_reg.write(cpu_mem_write_byte_enable.read());
+			} else {
+				//The CPU clock was skipped by DVFS, its outputs are the same ones and a store is not registered twice
+				cpu_mem_write_byte_enable_reg.write(0);
+			}
 
 			if(cpu_mem_address_reg.read()==IRQ_MASK && write_enable.read()==1){
 				irq_mask_reg.write(cpu_mem_data_write_reg.read());
@@ -221,6 +314,41 @@ void pe::sequential_attr(){
 		}
 		//*********************************************************************
 
+		//****************** DVFS **********************************
+		if (cpu_mem_address_reg.read() == DVFS_LEVEL && write_enable.read() == 1){
+			if (cpu_mem_data_write_reg.read() < DVFS_LEVELS)
+				dvfs_level.write(cpu_mem_data_write_reg.read());
+			else
+				dvfs_level.write(DVFS_LEVELS-1);
+		}
+		dvfs_cycles[dvfs_level.read()]++;
+		if (clock_aux && dvfs_tick.read())
+			dvfs_cpu_cycles[dvfs_level.read()]++;
+		dvfs_inst[dvfs_level.read()] += cpu->global_inst - dvfs_last_inst;
+		dvfs_last_inst = cpu->global_inst;
+		//*********************************************************************
+
+		//****************** performance counters **********************************
+		if (cpu_mem_address_reg.read() == PERF_SELECT && write_enable.read() == 1){
+			perf_select.write(cpu_mem_data_write_reg.read());
+		}
+		if (clock_aux){
+			perf_cycles[current_page.read()]++;
+			if (cpu_mem_pause.read() == 1)
+				perf_stalls[current_page.read()]++;
+		}
+		for(int i=0; i<CS_SUBNETS_NUMBER; i++){
+			if (tx_dmni_cs[i].read() && credit_i_dmni_cs[i].read())
+				perf_sent[i] += TAM_CS_FLIT/8;
+			if (rx_dmni_cs[i].read() && credit_o_dmni_cs[i].read())
+				perf_received[i] += TAM_CS_FLIT/8;
+		}
+		if (tx_dmni_ps.read() && credit_i_dmni_ps.read())
+			perf_sent[PS_NET_INDEX] += TAM_FLIT/8;
+		if (rx_dmni_ps.read() && credit_o_dmni_ps.read())
+			perf_received[PS_NET_INDEX] += TAM_FLIT/8;
+		//*********************************************************************
+
 		//************** simluation-time debug implementation *******************
 		if (cpu_mem_address_reg.read() == DEBUG && write_enable.read() == 1){
 			sprintf(aux, "log/log%dx%d.txt", (unsigned int) router_address.range(15,8), (unsigned int) router_address.range(7,0));
@@ -431,6 +559,16 @@ void pe::clock_stop(){
 	if (reset.read() == 1) {
 		tick_counter_local.write(0);
 		clock_aux = true;
+		dvfs_counter = 0;
+		dvfs_enable = true;
+		dvfs_tick.write(1);
+	}
+
+	//DVFS clock divider, evaluated at each rising edge of the PE clock
+	if (clock.posedge()){
+		dvfs_counter = (dvfs_counter + 1) % (1 << dvfs_level.read());
+		dvfs_enable = (dvfs_counter == 0);
+		dvfs_tick.write(dvfs_enable);
 	}
 
 	if((cpu_mem_address_reg.read() == CLOCK_HOLD) && (write_enable.read() == 1)){
@@ -441,10 +579,15 @@ void pe::clock_stop(){
 		clock_aux = true;
 	}
 
-	if((clock and clock_aux) == true){
+	if((clock and clock_aux and dvfs_enable) == true){
 		tick_counter_local.write((tick_counter_local.read() + 1) );
 	}
 
-	clock_hold.write(clock and clock_aux);
+#if TRAFFIC_GENERATOR
+	//The CPU stays held, the local port of the PS router is driven by the traffic generator
+	clock_hold.write(0);
+#else
+	clock_hold.write(clock and clock_aux and dvfs_enable);
+#endif
 
 }
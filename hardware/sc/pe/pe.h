@@ -9,7 +9,11 @@
 #include "PS_router/router_cc.h"
 #include "CS_router/CS_router.h"
 #include "CS_config/CS_config.h"
+#include "msg_request_table/msg_request_table.h"
 #include "memory/ram.h"
+#if TRAFFIC_GENERATOR
+#include "../peripherals/traffic_generator.h"
+#endif
 
 SC_MODULE(pe) {
 	
@@ -70,9 +74,33 @@ SC_MODULE(pe) {
 	sc_signal<sc_uint<3> > 		config_outport_subconfig;
 	sc_signal<regCSnet > 		config_valid_subconfig;
 
+	//Message request table
+	sc_signal <bool > 			msg_req_absorb;
+	sc_signal <bool > 			msg_req_intr;
+	sc_signal <reg32 > 			msg_req_result;
+	sc_signal <reg32 > 			msg_req_result_tasks;
+
+	//Performance counters, instructions and interrupts per page are kept by the cpu
+	sc_signal <reg32 > 			perf_select;
+	unsigned long int 			perf_cycles		[PERF_PAGES];
+	unsigned long int 			perf_stalls		[PERF_PAGES];
+	unsigned long int 			perf_sent		[SUBNETS_NUMBER];
+	unsigned long int 			perf_received	[SUBNETS_NUMBER];
+
+	//DVFS, the CPU clock is enabled once every 2^dvfs_level cycles. The cycles and instructions spent at each level feed the energy log
+	sc_signal <reg8 > 			dvfs_level;
+	sc_signal <bool > 			dvfs_tick;		//The CPU clock was enabled at the last rising edge
+	bool 						dvfs_enable;
+	unsigned int 				dvfs_counter;
+	unsigned long int 			dvfs_cycles		[DVFS_LEVELS];
+	unsigned long int 			dvfs_cpu_cycles	[DVFS_LEVELS];
+	unsigned long int 			dvfs_inst		[DVFS_LEVELS];
+	unsigned long int 			dvfs_last_inst;
+
 	//ram
 	sc_signal < sc_uint <30 > > addr_a;
 	sc_signal < sc_uint <30 > > addr_b;
+	sc_signal < sc_uint <30 > > addr_c;
 	sc_signal < sc_uint <32 > > data_read_ram;
 	sc_signal < sc_uint <32 > > mem_data_read;
 
@@ -98,17 +126,28 @@ SC_MODULE(pe) {
 	sc_signal< bool > 			rx_dmni_ps, tx_router_local_ps;
 	sc_signal< regflit > 		data_in_dmni_ps;
 	sc_signal< bool > 			credit_o_dmni_ps;
+#if TRAFFIC_GENERATOR
+		//DMNI PS outputs, unused while the traffic generator drives the local port
+	sc_signal< bool > 			tx_dmni_unused;
+	sc_signal< regflit > 		data_out_dmni_unused;
+	sc_signal< bool > 			credit_o_dmni_unused;
+#endif
 		//Configuration
 	sc_signal <bool > 			cpu_valid_dmni;
-	sc_signal <sc_uint<3> > 	cpu_code_dmni;
+	sc_signal <sc_uint<4> > 	cpu_code_dmni;
 		//Status
 	sc_signal < regSubnet > 	dmni_send_active;
 	sc_signal < regSubnet > 	dmni_receive_active;
 		//Interruption
 	sc_signal < regSubnet > 	dmni_intr;
+	sc_signal < bool > 			dmni_ring_intr;
+	sc_signal < reg32 > 		dmni_ring_done;
+	sc_signal < reg8 > 			dmni_recv_pending;
+	sc_signal < bool > 			dmni_copy_active;
 
 	//Others DMNI related signals
 	sc_signal < sc_uint <32 > > dmni_mem_address;
+	sc_signal < sc_uint <32 > > dmni_mem_write_address;
 	sc_signal < sc_uint <32 > > dmni_mem_addr_ddr;
 	sc_signal < bool > 			dmni_mem_ddr_read_req;
 	sc_signal < sc_uint <4 > > 	dmni_mem_write_byte_enable;
@@ -130,6 +169,10 @@ SC_MODULE(pe) {
 	router_cc 	*	ps_router;
 	CS_router	*	cs_router[CS_SUBNETS_NUMBER];
 	CS_config 	* 	cs_config;
+	msg_request_table * msg_req_table;
+#if TRAFFIC_GENERATOR
+	traffic_generator * traffic;
+#endif
 
 
 	/*unsigned long int log_interaction;
@@ -158,6 +201,7 @@ SC_MODULE(pe) {
 	//void log_process();
 	void comb_assignments();
 	void mem_mapped_registers();
+	unsigned int perf_value();
 	void reset_n_attr();
 	void clock_stop();
 	void end_of_simulation();
@@ -188,10 +232,12 @@ SC_MODULE(pe) {
 		mem->data_write_a(cpu_mem_data_write);
 		mem->data_read_a(data_read_ram);
 		mem->enable_b(dmni_enable_internal_ram);
-		mem->wbe_b(dmni_mem_write_byte_enable);
 		mem->address_b(addr_b);
-		mem->data_write_b(dmni_mem_data_write);
 		mem->data_read_b(mem_data_read);
+		mem->enable_c(dmni_enable_internal_ram);
+		mem->wbe_c(dmni_mem_write_byte_enable);
+		mem->address_c(addr_c);
+		mem->data_write_c(dmni_mem_data_write);
 
 		dmni = new dmni_qos("dmni_qos", (int) router_address);
 		dmni->clock(clock);
@@ -205,9 +251,14 @@ SC_MODULE(pe) {
 		dmni->intr_subnet	(dmni_intr);
 		dmni->send_active	(dmni_send_active);
 		dmni->receive_active(dmni_receive_active);
+		dmni->ring_intr		(dmni_ring_intr);
+		dmni->ring_done_out	(dmni_ring_done);
+		dmni->recv_pending	(dmni_recv_pending);
+		dmni->copy_active	(dmni_copy_active);
 
 		//Memory interface
 		dmni->mem_address	(dmni_mem_address);
+		dmni->mem_write_address(dmni_mem_write_address);
 		dmni->mem_data_write(dmni_mem_data_write);
 		dmni->mem_data_read	(dmni_mem_data_read);
 		dmni->mem_byte_we	(dmni_mem_write_byte_enable);
@@ -223,12 +274,32 @@ SC_MODULE(pe) {
 		}
 
 		//NoC PS Interface (Local port)
+#if TRAFFIC_GENERATOR
+		//The traffic generator drives the local port, the DMNI only sees rx_dmni_ps, which is kept at 0
+		dmni->tx_ps			(tx_dmni_unused);
+		dmni->data_out_ps	(data_out_dmni_unused);
+		dmni->credit_in_ps	(credit_i_dmni_ps);
+		dmni->rx_ps			(rx_dmni_ps);
+		dmni->data_in_ps	(data_in_dmni_ps);
+		dmni->credit_out_ps	(credit_o_dmni_unused);
+
+		traffic = new traffic_generator("traffic_generator", (router_address >> 8) + (router_address & 0xFF)*N_PE_X);
+		traffic->clock		(clock);
+		traffic->reset		(reset);
+		traffic->rx			(tx_router_local_ps);
+		traffic->data_in	(data_in_dmni_ps);
+		traffic->credit_out	(credit_o_dmni_ps);
+		traffic->tx			(tx_dmni_ps);
+		traffic->data_out	(data_out_dmni_ps);
+		traffic->credit_in	(credit_i_dmni_ps);
+#else
 		dmni->tx_ps			(tx_dmni_ps);
 		dmni->data_out_ps	(data_out_dmni_ps);
 		dmni->credit_in_ps	(credit_i_dmni_ps);
 		dmni->rx_ps			(rx_dmni_ps);
 		dmni->data_in_ps	(data_in_dmni_ps);
 		dmni->credit_out_ps	(credit_o_dmni_ps);
+#endif
 
 
 		//CS routers wiring
@@ -303,6 +374,21 @@ SC_MODULE(pe) {
 		cs_config->wait_header(config_wait_header);
 		cs_config->config_en(config_en);
 
+		msg_req_table = new msg_request_table("msg_request_table", router_address);
+		msg_req_table->clock(clock);
+		msg_req_table->reset(reset);
+		msg_req_table->rx(tx_router_local_ps);
+		msg_req_table->data_in(data_in_dmni_ps);
+		msg_req_table->credit_o(credit_o_dmni_ps);
+		msg_req_table->absorb(msg_req_absorb);
+		msg_req_table->cpu_address(cpu_mem_address_reg);
+		msg_req_table->cpu_data(cpu_mem_data_write_reg);
+		msg_req_table->cpu_write(write_enable);
+		msg_req_table->result(msg_req_result);
+		msg_req_table->result_tasks(msg_req_result_tasks);
+		msg_req_table->intr(msg_req_intr);
+		msg_req_table->tick_counter(tick_counter);
+
 		SC_METHOD(reset_n_attr);
 		sensitive << reset;
 		
@@ -313,20 +399,25 @@ SC_MODULE(pe) {
 		sensitive << clock.pos() << reset.pos();*/
 
 		SC_METHOD(comb_assignments);
-		sensitive << cpu_mem_address << dmni_mem_address << cpu_mem_address_reg << write_enable;
+		sensitive << cpu_mem_address << dmni_mem_address << dmni_mem_write_address << cpu_mem_address_reg << write_enable;
 		sensitive << cpu_mem_data_write_reg << irq_mask_reg << irq_status;
 		sensitive << time_slice << tick_counter_local;
 		sensitive << dmni_send_active << dmni_receive_active << data_read_ram;
 		sensitive << cpu_valid_dmni << cpu_code_dmni << dmni_enable_internal_ram;
 		sensitive << mem_data_read << cpu_enable_ram << cpu_mem_write_byte_enable_reg << dmni_mem_write_byte_enable;
-		sensitive << dmni_mem_data_write << dmni_intr << slack_update_timer;
+		sensitive << dmni_mem_data_write << dmni_intr << dmni_ring_intr << slack_update_timer;
 		sensitive << cpu_code_dmni << req_in_reg << tx_router_local_ps;
 		sensitive << config_inport_subconfig << config_outport_subconfig;
 		sensitive << data_in_dmni_ps << config_wait_header << config_en << dmni_rec_en;
 		sensitive << config_valid_subconfig;
+		sensitive << msg_req_absorb << msg_req_intr;
 		
 		SC_METHOD(mem_mapped_registers);
 		sensitive << cpu_mem_address_reg;
+		sensitive << dmni_ring_done << dmni_recv_pending;
+		sensitive << msg_req_result << msg_req_result_tasks;
+		sensitive << perf_select;
+		sensitive << dvfs_level;
 		sensitive << tick_counter_local;
 		sensitive << data_read_ram;
 		sensitive << time_slice;
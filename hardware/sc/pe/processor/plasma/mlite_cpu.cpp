@@ -68,6 +68,11 @@ void mlite_cpu::mlite() {
 	shift_inst_tasks     		= 0;	
 	nop_inst_tasks     		= 0;	
 	mult_div_inst_tasks     	= 0;
+
+	for(int i=0; i<PERF_PAGES; i++){
+		page_inst[i] = 0;
+		page_intr[i] = 0;
+	}
   
   
 	for(;;) {
@@ -98,6 +103,7 @@ void mlite_cpu::mlite() {
 			if ( intr_in.read() && intr_enable && !jump_or_branch ) {	// Does not interrupt a Branch Delay Slot.
 				state->epc = state->pc - 4;
 				state->pc = 0x3C;
+				page_intr[page>>shift]++;
 				page = 0;
 				mem_address.write(state->pc);
 				opcode = mem_data_r.read();
@@ -112,6 +118,7 @@ void mlite_cpu::mlite() {
 
 			// Adds the page number.
 			state->pc |= page;
+			inst_page = page>>shift;	// Page that retires this instruction, page may change during its execution
 
 			// Instruction read.
 			mem_address.write(state->pc);
@@ -145,6 +152,7 @@ void mlite_cpu::mlite() {
 
 				nop_inst_kernel=(page != 0? nop_inst_kernel : nop_inst_kernel + 1 );
 				nop_inst_tasks=(page != 0? nop_inst_tasks + 1  : nop_inst_tasks );
+				page_inst[inst_page]++;
 				wait(1);
 				no_execute_branch_delay_slot = false;
 				continue;
@@ -1424,6 +1432,7 @@ void mlite_cpu::mlite() {
 			nop_inst					= nop_inst_kernel + nop_inst_tasks;			
 			mult_div_inst					= mult_div_inst_kernel + mult_div_inst_tasks;
 			global_inst = global_inst_kernel + global_inst_tasks;
+			page_inst[inst_page]++;
 
 		}		// else
 	}			// for(;;)
@@ -57,7 +57,7 @@ SC_MODULE(mlite_cpu) {
 	int imm_shift;
 	int *r, word_addr;
 	unsigned int *u;
-	unsigned int ptr, page, byte_write;
+	unsigned int ptr, page, inst_page, byte_write;
 	unsigned char big_endian, shift;
 	sc_uint<4> byte_en;
 
@@ -103,6 +103,10 @@ SC_MODULE(mlite_cpu) {
 	  unsigned long int shift_inst_tasks;
    	  unsigned long int nop_inst_tasks;
 	  unsigned long int mult_div_inst_tasks;
+
+	  /* Per page counters, read at runtime through the PE performance counter block */
+	  unsigned long int page_inst[PERF_PAGES];
+	  unsigned long int page_intr[PERF_PAGES];
  
 	/*** Process function ***/
 	void mlite();
@@ -55,15 +55,142 @@ string app_injector::get_app_repo_path(unsigned int app_id){
 
 }
 
+/**Reads the compressed code of a task from repository_lz.txt, generated by app_builder.py when the testcase enables
+ * task_code_compression. Each task stores its compressed size in words followed by the compressed code.
+ * Returns the compressed size, 0 when the file does not exists or the code of the task is not compressed
+ */
+unsigned int app_injector::compressed_code_loader(string repo_path, unsigned int task_id, unsigned int * &code){
+	string line;
+	string path = repo_path.substr(0, repo_path.rfind("/")) + "/repository_lz.txt";
+	ifstream lz_file (path.c_str());
+	unsigned int compressed_size = 0;
+
+	code = NULL;
+
+	if (!lz_file.is_open())
+		return 0;
+
+	for(unsigned int task = 0; task <= task_id; task++){
+
+		if (!getline (lz_file,line))
+			return 0;
+		sscanf( line.substr(0, 8).c_str(), "%x", &compressed_size);
+
+		if (task == task_id)
+			break;
+
+		/*Skips the compressed code of the previous tasks*/
+		for(unsigned int i=0; i<compressed_size; i++)
+			getline (lz_file,line);
+	}
+
+	if (compressed_size == 0)
+		return 0;
+
+	code = new unsigned int[compressed_size];
+
+	for(unsigned int i=0; i<compressed_size; i++){
+		getline (lz_file,line);
+		sscanf( line.substr(0, 8).c_str(), "%x", &code[i]);
+	}
+
+	return compressed_size;
+}
+
+/**Reads the descriptor and the code (TEXT and DATA sections) of a task from the app repository file.
+ * Returns a new array with the task code, NULL when the repository cannot be read
+ */
+unsigned int * app_injector::task_code_reader(string path, unsigned int task_id, unsigned int &code_size, unsigned int &data_size, unsigned int &bss_size){
+
+	string line;
+	unsigned int  task_number, task_line, code_line, current_line;
+	unsigned int * code;
+
+	ifstream repo_file (path.c_str());
+
+	if (!repo_file.is_open()) {
+		cout << "ERROR cannot read the file at path: " << path << endl;
+		return NULL;
+	}
+
+	getline (repo_file,line);
+	sscanf( line.substr(0, 8).c_str(), "%x", &task_number);
+
+	if (task_id+1 > task_number)
+		throw std::invalid_argument("ERROR[1] - task_id is out of range");
+
+	task_line = (TASK_DESCRIPTOR_SIZE * task_id);
+	/*Skips TASK_DESCRIPTOR_SIZE lines - TASK_DESCRIPTOR_SIZE is the size of each task description in repository.txt for each app*/
+	for (unsigned int i=0; i < task_line; i++)
+		getline (repo_file,line);
+
+	getline (repo_file,line); /*Task ID*/
+	getline (repo_file,line); /*static mapped PE*/
+	getline (repo_file,line); /*code size*/
+	sscanf( line.substr(0, 8).c_str(), "%x", &code_size);
+	getline (repo_file,line); /*data size*/
+	sscanf( line.substr(0, 8).c_str(), "%x", &data_size);
+	getline (repo_file,line); /*bss size*/
+	sscanf( line.substr(0, 8).c_str(), "%x", &bss_size);
+	getline (repo_file,line); /*initial_address*/
+	sscanf( line.substr(0, 8).c_str(), "%x", &code_line);
+
+	code_line = code_line / 4; /*Divided by 4 because memory has 4 byte words*/
+
+	current_line = task_line + TASK_DESCRIPTOR_SIZE + 1; /*Finds the current line by sum the number of task by the task decription size*/
+
+	//cout << "Current line: " << current_line << endl;
+	/*Points the reader to the beging of task code*/
+	while(current_line < code_line){
+		getline (repo_file,line);
+		current_line++;
+	}
+	//cout << "Task ID " << task_id << " code size " << code_size << " code_line " << code_line << endl;
+
+	code = new unsigned int[code_size];
+
+	for(unsigned int i=0; i<code_size; i++){
+		getline (repo_file,line);
+		sscanf( line.substr(0, 8).c_str(), "%x", &code[i]);
+	}
+
+	return code;
+}
+
+/**FNV-1a hash of the task TEXT section. The kernel tags the task page with this hash, allowing the local mapper
+ * to reference the code kept into the page after the task terminates (task code cache). It never returns 0, which
+ * means an unknown code into the kernel
+ */
+unsigned int app_injector::code_hash(unsigned int * code, unsigned int text_size){
+
+	unsigned int hash = 2166136261u;
+
+	for(unsigned int i=0; i<text_size; i++){
+		for(int b=24; b>=0; b-=8){
+			hash ^= (code[i] >> b) & 0xFF;
+			hash *= 16777619u;
+		}
+	}
+
+	return (hash == 0) ? 1 : hash;
+}
+
 /**Assembles the packet that load the a generic task to the system
+ * When cached is 1 the TEXT section is already into a free page of the target PE and only the DATA section is sent
+ * The packet is returned by pkt and pkt_size, pkt is NULL when the task code cannot be loaded
  */
-void app_injector::task_allocation_loader(unsigned int full_task_id, unsigned int real_task_id, unsigned int master_ID, unsigned int allocated_proc){
+void app_injector::task_allocation_loader(unsigned int full_task_id, unsigned int real_task_id, unsigned int master_ID, unsigned int allocated_proc, unsigned int cached, unsigned int * &pkt, unsigned int &pkt_size){
 
-	string line, path;
-	unsigned int  task_number, code_size, data_size, bss_size, task_line, code_line, current_line;
+	string path;
+	unsigned int code_size, data_size, bss_size, compressed_size, hash;
+	unsigned int * code;
+	unsigned int * compressed_code;
 	int ptr_index = 0;
 	unsigned int app_id, task_id;
 
+	pkt = NULL;
+	pkt_size = 0;
+
 	app_id = full_task_id >> 8;
 	task_id = full_task_id & 0xFF;
 
@@ -72,75 +199,70 @@ void app_injector::task_allocation_loader(unsigned int full_task_id, unsigned in
 		//cout << "Real task ID updated to " << real_task_id << endl;
 	}
 
-	cout << "Loading task ID " << full_task_id << " to PE " << (allocated_proc >> 8) << "x" << (allocated_proc & 0xFF) << endl;
+	cout << "Loading task ID " << full_task_id << " to PE " << (allocated_proc >> 8) << "x" << (allocated_proc & 0xFF) << (cached ? " (cached code)" : "") << endl;
 
 
 	path = get_app_repo_path(app_id);
 
 	//cout << "Task allocation loader - app path: " << path << endl;
 
-	ifstream repo_file (path.c_str());
-
-	if (repo_file.is_open()) {
+	code = task_code_reader(path, task_id, code_size, data_size, bss_size);
 
-		getline (repo_file,line);
-		sscanf( line.substr(0, 8).c_str(), "%x", &task_number);
-
-		if (task_id+1 > task_number)
-			throw std::invalid_argument("ERROR[1] - task_id is out of range");
-
-		task_line = (TASK_DESCRIPTOR_SIZE * task_id);
-		/*Skips TASK_DESCRIPTOR_SIZE lines - TASK_DESCRIPTOR_SIZE is the size of each task description in repository.txt for each app*/
-		for (unsigned int i=0; i < task_line; i++)
-			getline (repo_file,line);
-
-		getline (repo_file,line); /*Task ID*/
-		getline (repo_file,line); /*static mapped PE*/
-		getline (repo_file,line); /*code size*/
-		sscanf( line.substr(0, 8).c_str(), "%x", &code_size);
-		getline (repo_file,line); /*data size*/
-		sscanf( line.substr(0, 8).c_str(), "%x", &data_size);
-		getline (repo_file,line); /*bss size*/
-		sscanf( line.substr(0, 8).c_str(), "%x", &bss_size);
-		getline (repo_file,line); /*initial_address*/
-		sscanf( line.substr(0, 8).c_str(), "%x", &code_line);
-
-		code_line = code_line / 4; /*Divided by 4 because memory has 4 byte words*/
-
-		current_line = task_line + TASK_DESCRIPTOR_SIZE + 1; /*Finds the current line by sum the number of task by the task decription size*/
+	if (code == NULL){
+		cout << "ERROR cannot load the task code of app id " << app_id << endl;
+		return;
+	}
 
-		//cout << "Current line: " << current_line << endl;
-		/*Points the reader to the beging of task code*/
-		while(current_line < code_line){
-			getline (repo_file,line);
-			current_line++;
-		}
-		//cout << "Task ID " << task_id << " code size " << code_size << " code_line " << code_line << endl;
+	hash = code_hash(code, code_size - data_size);
 
-		packet_size = code_size+CONSTANT_PACKET_SIZE;
+	compressed_size = 0;
+	compressed_code = NULL;
 
-		packet = new unsigned int[packet_size];
+	if (cached)
+		pkt_size = data_size+CONSTANT_PACKET_SIZE;
+	else {
+		compressed_size = compressed_code_loader(path, task_id, compressed_code);
 
-		packet[0] = allocated_proc; //Packet service
-		packet[1] = packet_size-2; //Packet service
-		packet[2] = TASK_ALLOCATION; //Packet service
-		packet[3] = full_task_id;
-		packet[4] = master_ID; //Master ID
-		packet[9] = data_size; //Data size
-		packet[10] = code_size; //Code size
-		packet[11] = bss_size; //Bss size
-		ptr_index 			= CONSTANT_PACKET_SIZE; //Jumps to the end of ServiceHeader
+		if (compressed_size)
+			pkt_size = compressed_size+CONSTANT_PACKET_SIZE;
+		else
+			pkt_size = code_size+CONSTANT_PACKET_SIZE;
+	}
 
-		//Assembles txt
-		for(unsigned int i=0; i<code_size; i++){
-			getline (repo_file,line);
-			sscanf( line.substr(0, 8).c_str(), "%x", &packet[ptr_index++]);
-			//cout << line << endl;
-		}
+	pkt = new unsigned int[pkt_size];
+
+	pkt[0] = allocated_proc; //Packet service
+	pkt[1] = pkt_size-2; //Packet service
+	pkt[2] = TASK_ALLOCATION; //Packet service
+	pkt[3] = full_task_id;
+	pkt[4] = master_ID; //Master ID
+	pkt[7] = hash; //Code hash, tags the page into the kernel task code cache
+	pkt[8] = cached; //Only the data section is sent
+	pkt[9] = data_size; //Data size
+	pkt[10] = code_size; //Code size
+	pkt[11] = bss_size; //Bss size
+	pkt[12] = compressed_size; //Compressed code size, 0 means that the code is not compressed
+	ptr_index 			= CONSTANT_PACKET_SIZE; //Jumps to the end of ServiceHeader
+
+	if (cached){
+		//Assembles the data section, placed at the end of the code
+		for(unsigned int i=code_size-data_size; i<code_size; i++)
+			pkt[ptr_index++] = code[i];
+
+	} else if (compressed_size){
+		//Assembles the compressed txt, decoded by the kernel
+		for(unsigned int i=0; i<compressed_size; i++)
+			pkt[ptr_index++] = compressed_code[i];
+
+		delete [] compressed_code;
 
 	} else {
-		cout << "ERROR cannot read the file at path: " << path << " and app id " << app_id << endl;
+		//Assembles txt
+		for(unsigned int i=0; i<code_size; i++)
+			pkt[ptr_index++] = code[i];
 	}
+
+	delete [] code;
 }
 
 void app_injector::bootloader(){
@@ -153,14 +275,19 @@ void app_injector::bootloader(){
 
 			/*Sends the Global Mapper App to PE 0 */
 			case INITIALIZE:
+				/*Only the first injector boots the system, the other ones just serve applications*/
+				if (injector_index != 0){
+					EA_bootloader = BOOTLOADER_FINISHED;
+					break;
+				}
 				/*Load the boot task in the packet array*/
-				task_allocation_loader(0,0,0,0);
+				task_allocation_loader(0,0,0,0,0, packet, packet_size);
 				/*This state signals to send_packet to start transmission*/
 				EA_bootloader = WAIT_SEND_BOOT;
 				break;
 			case WAIT_SEND_BOOT:
 				/*Waits ends of boot packet transmission*/
-				if (EA_send_packet == SEND_FINISHED)
+				if (EA_send_packet == SEND_FINISHED && !sending_allocation)
 					EA_bootloader = BOOTLOADER_FINISHED;
 				break;
 			case BOOTLOADER_FINISHED:
@@ -179,6 +306,8 @@ void app_injector::bootloader(){
  * - app_task_number
  * - req_app_cluster_id (statically mapped cluster address)
  *
+ * Applications owned by other injectors (app_counter % injector_number != injector_index) are skipped.
+ *
  * WAITING_TIME: Waits the simulation reach the time to fires a NEW_APP_REQ to the global manager
  * The appsstart.txt file had the applications sorted by its time to entry on the system.
  *
@@ -196,6 +325,7 @@ void app_injector::monitor_new_app(){
 		req_app_start_time = 0;
 		req_app_task_number = 0;
 		req_app_cluster_id = 0;
+		app_counter = 0;
 		line_counter = MAN_APP_DESCRIPTOR_SIZE; //6 is the number of lines after MAN_app_application
 
 	} else if (clock.posedge()){
@@ -254,7 +384,12 @@ void app_injector::monitor_new_app(){
 							line_counter++;
 						}
 
-						EA_new_app_monitor = WAITING_TIME;
+						//The application is requested by other injector, keeps monitoring
+						if ((app_counter++ % injector_number) != injector_index){
+							delete [] task_static_mapping;
+							task_static_mapping = NULL;
+						} else
+							EA_new_app_monitor = WAITING_TIME;
 					}
 
 					appstart_file.close();
@@ -269,21 +404,22 @@ void app_injector::monitor_new_app(){
 
 				if (EA_receive_packet == HEADER && EA_bootloader == BOOTLOADER_FINISHED && (req_app_start_time * 100000) <= current_time){
 
-					packet_size = CONSTANT_PACKET_SIZE+3;
+					packet_size = CONSTANT_PACKET_SIZE+4;
 
 					packet = new unsigned int[packet_size];
 
-					packet[0] = MPE_ADDR;
+					packet[0] = MPE_ADDR | PRIORITY_PKT;
 					packet[1] = packet_size - 2;
 					packet[2] = NEW_APP_REQ;
 					packet[4] = 0; //Task Global Mapper
-					packet[8] = 3; //Payload lenght
+					packet[8] = 4; //Payload lenght
 					packet[CONSTANT_PACKET_SIZE] = NEW_APP_REQ;
 					packet[CONSTANT_PACKET_SIZE+1] = req_app_cluster_id;
 					packet[CONSTANT_PACKET_SIZE+2] = req_app_task_number;
+					packet[CONSTANT_PACKET_SIZE+3] = injector_index; //The global mapper answers to this injector
 					//cout << "NEW_APP_SENT" << endl;
 
-					cout << "App Injector requesting app " << req_app_name << endl;
+					cout << "App Injector " << injector_index << " requesting app " << req_app_name << endl;
 
 					EA_new_app_monitor = WAITING_SEND_APP_REQ;
 				}
@@ -292,7 +428,7 @@ void app_injector::monitor_new_app(){
 
 			case WAITING_SEND_APP_REQ:
 
-				if (EA_send_packet == SEND_FINISHED)
+				if (EA_send_packet == SEND_FINISHED && !sending_allocation)
 					EA_new_app_monitor = IDLE_MONITOR;
 
 				break;
@@ -320,6 +456,8 @@ void app_injector::app_descriptor_loader(){
 	int ptr_index;
 	int allocated_proc_index;
 	int task_index;
+	unsigned int * code;
+	unsigned int code_size, data_size, bss_size;
 
 	file_length = 0;
 	ptr_index = 0;
@@ -339,7 +477,7 @@ void app_injector::app_descriptor_loader(){
 		packet = new unsigned int[packet_size];
 
 		//Assembles the Service Header on packet
-		packet[0] = (cluster_address & 0xFFFF); // Manager address
+		packet[0] = (cluster_address & 0xFFFF) | PRIORITY_PKT; // Manager address
 		packet[1] = packet_size - 2; // Packet payload
 		packet[2] = NEW_APP;
 		packet[4] = (cluster_address >> 16); //Task Global Mapper
@@ -361,6 +499,10 @@ void app_injector::app_descriptor_loader(){
 			if(i == allocated_proc_index){//If the current line is the allocated proc, then inserts the statically mapped process address
 				packet[ptr_index++] = task_static_mapping[task_index++];
 				allocated_proc_index += TASK_DESCRIPTOR_SIZE; //Jumps the index to the next field of allocated proc
+			} else if(i == allocated_proc_index - TASK_DESCRIPTOR_SIZE + 4){//The initial address is replaced by the code hash, used by the local mapper to track the task code cache
+				code = task_code_reader(path, task_index-1, code_size, data_size, bss_size);
+				packet[ptr_index++] = code_hash(code, code_size - data_size);
+				delete [] code;
 			} else
 				sscanf( line.substr(0, 8).c_str(), "%x", &packet[ptr_index++]);
 		}
@@ -399,27 +541,30 @@ void app_injector::app_descriptor_loader(){
  *  | id | repoaddr | code_size | allocatedproc |
  *
  *
- *  These information are stored in memory using the tasks_info pointer. After finish to receive the packe, this state
- *  calls the function "task_allocation_loader". Such function creates a continuous memory block (packet pointer), which
- *  stores all TASK_ALLOCATION packet, and that will be sent to the slave PE of each task.
+ *  After finish to receive the packet, this state pushes an allocation job into allocation_queue and goes back to HEADER, without
+ *  waiting the TASK_ALLOCATION be sent. Then, several allocation requests can be outstanding, while the APP_REQ_ACK of other
+ *  applications are still served. The credit is only held when the queue is full.
  *
- *  OBS: The functions "task_allocation_loader" and "app_descriptor_loader" create a continuos block memory storing its address in
- *  pointer *packet and its size in the variable packet_size. Both pointer and variable are used by the send_packet function to send a
- *  packet to the NoC.
+ *  OBS: The function "app_descriptor_loader" creates a continuos block memory storing its address in pointer *packet and its size
+ *  in the variable packet_size. The allocation jobs have its own packet, loaded by allocation_prefetch. Both are used by the
+ *  send_packet function to send a packet to the NoC.
  */
 void app_injector::receive_packet(){
 
+	AllocationJob * job;
+
 	if (reset.read() == 1)  {
 		EA_receive_packet = HEADER;
 		req_task_id = 0;
 		req_task_allocated_proc = 0;
 		req_task_master_ID = 0;
 		req_task_id_real = 0;
+		req_task_cached = 0;
 		sig_credit_out.write(1);
 	} else {
 
 		/*Credit out update*/
-		if (EA_receive_packet == WAITING_SEND_NEW_APP || EA_receive_packet == WAITING_SEND_TASK_ALLOCATION || EA_new_app_monitor == WAITING_SEND_APP_REQ)
+		if (EA_receive_packet == WAITING_SEND_NEW_APP || alloc_count == ALLOCATION_QUEUE_SIZE || EA_new_app_monitor == WAITING_SEND_APP_REQ)
 			sig_credit_out.write(0);
 		else
 			sig_credit_out.write(1);
@@ -508,13 +653,25 @@ void app_injector::receive_packet(){
 						case 7:
 							req_task_id_real = data_in.read();
 							break;
+						case 8:
+							req_task_cached = data_in.read();
+							break;
 						default:
 							break;
 					}
 
 					if (payload_size == 0){
-						task_allocation_loader(req_task_id, req_task_id_real, req_task_master_ID, req_task_allocated_proc);
-						EA_receive_packet = WAITING_SEND_TASK_ALLOCATION;
+						//Enqueues the job, its packet is loaded by allocation_prefetch
+						job = &allocation_queue[(alloc_head + alloc_count) % ALLOCATION_QUEUE_SIZE];
+						job->task_id = req_task_id;
+						job->task_id_real = req_task_id_real;
+						job->master_ID = req_task_master_ID;
+						job->allocated_proc = req_task_allocated_proc;
+						job->cached = req_task_cached;
+						job->packet = NULL;
+						job->packet_size = 0;
+						alloc_count++;
+						EA_receive_packet = HEADER;
 					}
 				}
 
@@ -527,12 +684,7 @@ void app_injector::receive_packet(){
 				break;
 
 			case WAITING_SEND_NEW_APP:
-				if (EA_send_packet == SEND_FINISHED)
-					EA_receive_packet = HEADER;
-				break;
-
-			case WAITING_SEND_TASK_ALLOCATION:
-				if (EA_send_packet == SEND_FINISHED)
+				if (EA_send_packet == SEND_FINISHED && !sending_allocation)
 					EA_receive_packet = HEADER;
 				break;
 		}//end switch
@@ -546,14 +698,54 @@ void app_injector::receive_packet(){
 }
 
 /**Sequential process
- * Only is in charge to send data to NoC using as reference the packet pointer and packet_size variable.
+ * Loads the TASK_ALLOCATION packet of the next allocation job not loaded yet. As it runs in parallel with send_packet,
+ * the task code of the next jobs is read from the repository while the current TASK_ALLOCATION streams to the NoC
  */
-void app_injector::send_packet(){
+void app_injector::allocation_prefetch(){
 
-	static unsigned int p_index = 0;
+	AllocationJob * job;
+
+	if (reset.read() == 1)  {
+		while(alloc_count > 0)
+			release_allocation_job();
+		alloc_head = 0;
+		alloc_loaded = 0;
+
+	} else if (alloc_loaded < alloc_count){
+
+		job = &allocation_queue[(alloc_head + alloc_loaded) % ALLOCATION_QUEUE_SIZE];
+
+		task_allocation_loader(job->task_id, job->task_id_real, job->master_ID, job->allocated_proc, job->cached, job->packet, job->packet_size);
+
+		alloc_loaded++;
+	}
+}
+
+/**Removes the job at the head of the allocation queue, releasing its packet
+ */
+void app_injector::release_allocation_job(){
+
+	AllocationJob * job = &allocation_queue[alloc_head];
+
+	if (job->packet != NULL)
+		delete [] job->packet;
+	job->packet = NULL;
+
+	alloc_head = (alloc_head + 1) % ALLOCATION_QUEUE_SIZE;
+	alloc_count--;
+	if (alloc_loaded > 0)
+		alloc_loaded--;
+}
+
+/**Sequential process
+ * Only is in charge to send data to NoC using as reference the tx_packet pointer and tx_size variable.
+ * The packets of the other FSMs (packet pointer) have priority over the loaded allocation jobs
+ */
+void app_injector::send_packet(){
 
 	if (reset.read() == 1)  {
 		EA_send_packet = IDLE;
+		sending_allocation = false;
 	} else {
 
 		switch (EA_send_packet) {
@@ -562,17 +754,32 @@ void app_injector::send_packet(){
 				//IDLE monitors the states of other FSM that acts as triggers
 				if (EA_new_app_monitor == WAITING_SEND_APP_REQ ||
 					EA_receive_packet == WAITING_SEND_NEW_APP ||
-					EA_receive_packet == WAITING_SEND_TASK_ALLOCATION ||
 					EA_bootloader == WAIT_SEND_BOOT
 					) {
 
 					if (credit_in.read() == 1){
 						if (packet != NULL) {
+							tx_packet = packet;
+							tx_size = packet_size;
+							sending_allocation = false;
 							EA_send_packet = SEND_PACKET;
 							p_index = 0;
 						} else
 							cout << "ERROR: packet has an NULL pointer at time " << current_time <<  endl;
 					}
+
+				} else if (alloc_loaded > 0 && credit_in.read() == 1){
+
+					if (allocation_queue[alloc_head].packet != NULL) {
+						tx_packet = allocation_queue[alloc_head].packet;
+						tx_size = allocation_queue[alloc_head].packet_size;
+						sending_allocation = true;
+						EA_send_packet = SEND_PACKET;
+						p_index = 0;
+					} else {
+						cout << "ERROR: allocation job of task " << allocation_queue[alloc_head].task_id << " dropped at time " << current_time <<  endl;
+						release_allocation_job();
+					}
 				}
 				break;
 
@@ -580,11 +787,11 @@ void app_injector::send_packet(){
 
 				if (credit_in.read() == 1){
 
-					if (packet_size > 0){
+					if (tx_size > 0){
 
 						tx.write(1);
-						data_out.write(packet[p_index++]);
-						packet_size--;
+						data_out.write(tx_packet[p_index++]);
+						tx_size--;
 
 					} else {
 						tx.write(0);
@@ -607,8 +814,13 @@ void app_injector::send_packet(){
 
 			case SEND_FINISHED:
 
-				delete[] packet;
-				packet = NULL;
+				if (sending_allocation)
+					release_allocation_job();
+				else {
+					delete[] packet;
+					packet = NULL;
+				}
+				tx_packet = NULL;
 				EA_send_packet = IDLE;
 
 				break;
@@ -20,9 +20,11 @@ using namespace std;
 #define TAM_FLIT 				32 	//Size of the Packet-Swtiching NoC flit
 #define CONSTANT_PACKET_SIZE	13 	//Constant ServiceHeader packet size (more info inside software/modules/packet.h)
 #define MPE_ADDR				0 	//PE address of the manager PE
+#define PRIORITY_PKT			0x10000000 //Header flit priority flag, keep it equal to PRIORITY_BIT of standards.h
 #define TASK_NUMBER_INDEX		8 	//Index where is the app task number information within packet APP_REQ_ACK
 #define TASK_DESCRIPTOR_SIZE	6	//6 is number of lines to represent a task description. Keeps this number equal to build_env/scripts/app_builder.py
 #define MAN_APP_DESCRIPTOR_SIZE	8 	//This number represents the number of lines that MAN_app has into the file my_scenario/appstart.txt. If you include a new MAN_app task, please increase this value in +1
+#define ALLOCATION_QUEUE_SIZE	16	//Maximum number of outstanding APP_ALLOCATION_REQUEST into the injector
 
 
 typedef sc_uint<TAM_FLIT > regflit;
@@ -35,6 +37,17 @@ typedef sc_uint<TAM_FLIT > regflit;
 #define 	APP_ALLOCATION_REQUEST			0x00000240 //Mestre to Injector (carries tasks properties and mapping)
 #define		APP_MAPPING_COMPLETE			0x00000440
 
+//Outstanding task allocation, received by an APP_ALLOCATION_REQUEST and waiting to be sent as a TASK_ALLOCATION packet
+typedef struct {
+	unsigned int task_id;
+	unsigned int task_id_real;
+	unsigned int master_ID;
+	unsigned int allocated_proc;
+	unsigned int cached;
+	unsigned int * packet;		//TASK_ALLOCATION packet, NULL until loaded by allocation_prefetch
+	unsigned int packet_size;
+} AllocationJob;
+
 SC_MODULE(app_injector){
 
 	//Ports
@@ -54,14 +67,19 @@ SC_MODULE(app_injector){
 
 	//Functions;
 	void app_descriptor_loader();
-	void task_allocation_loader(unsigned int, unsigned int, unsigned int, unsigned int);
+	void task_allocation_loader(unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int * &, unsigned int &);
+	unsigned int * task_code_reader(string, unsigned int, unsigned int &, unsigned int &, unsigned int &);
+	unsigned int code_hash(unsigned int *, unsigned int);
+	unsigned int compressed_code_loader(string, unsigned int, unsigned int * &);
 	string get_app_repo_path(unsigned int);
+	void release_allocation_job();
 
 	//Sequential logic
 	void bootloader();
 	void monitor_new_app();
 	void send_packet();
 	void receive_packet();
+	void allocation_prefetch();
 
 	//Combinational logic
 	void credit_out_update();
@@ -69,7 +87,7 @@ SC_MODULE(app_injector){
 	//FSM
 	enum FSM_bootloader{INITIALIZE, WAIT_SEND_BOOT, BOOTLOADER_FINISHED};
 	enum FSM_send_packet{IDLE, SEND_PACKET, WAITING_CREDIT, SEND_FINISHED};
-	enum FSM_receive_packet{HEADER, PAYLOAD_SIZE, SERVICE, RECEIVE_APP_ACK, RECEIVE_ALLOCATION_REQ, RECEIVE_MAPPING_COMPLETE, WAITING_SEND_NEW_APP, WAITING_SEND_TASK_ALLOCATION};
+	enum FSM_receive_packet{HEADER, PAYLOAD_SIZE, SERVICE, RECEIVE_APP_ACK, RECEIVE_ALLOCATION_REQ, RECEIVE_MAPPING_COMPLETE, WAITING_SEND_NEW_APP};
 	enum FSM_new_app_monitor{IDLE_MONITOR, MONITORING, WAITING_TIME, WAITING_SEND_APP_REQ};
 
 	enum FSM_bootloader 		EA_bootloader;
@@ -79,6 +97,12 @@ SC_MODULE(app_injector){
 
 	unsigned int current_time;
 
+	//Injector index and number of injectors of the system. The injector 0 boots the system and each injector
+	//requests the applications of appstart.txt in round-robin, i.e., the ones where app_counter % injector_number == injector_index
+	unsigned int injector_index;
+	unsigned int injector_number;
+	unsigned int app_counter;
+
 	//Line counter, used to wakl over app_start
 	unsigned int line_counter;
 
@@ -98,20 +122,42 @@ SC_MODULE(app_injector){
 	unsigned int req_task_allocated_proc;
 	unsigned int req_task_master_ID;
 	unsigned int req_task_id_real;
+	unsigned int req_task_cached;
+
+	//Allocation job queue, filled by receive_packet, loaded by allocation_prefetch and drained by send_packet
+	AllocationJob allocation_queue[ALLOCATION_QUEUE_SIZE];
+	unsigned int alloc_head;	//Index of the next job to be sent
+	unsigned int alloc_count;	//Number of jobs into the queue
+	unsigned int alloc_loaded;	//Number of jobs, from the head, with the packet already loaded
 
 	//Used inside EA_send_packet
 	unsigned int packet_size;
 	unsigned int * packet;
+	unsigned int * tx_packet;
+	unsigned int tx_size;
+	unsigned int p_index;
+	bool sending_allocation;	//The packet being sent is the one of the job at the head of allocation_queue
 
 
 	SC_HAS_PROCESS(app_injector);
-	app_injector (sc_module_name name_) : sc_module(name_) {
+	app_injector (sc_module_name name_, unsigned int injector_index_ = 0, unsigned int injector_number_ = 1) :
+		sc_module(name_), injector_index(injector_index_), injector_number(injector_number_) {
 
 		//Variable initialization
 		current_time = 0;
+		app_counter = 0;
+		p_index = 0;
 		line_counter = 0;
 		packet = 0;
 		packet_size = 0;
+		tx_packet = 0;
+		tx_size = 0;
+		sending_allocation = false;
+		alloc_head = 0;
+		alloc_count = 0;
+		alloc_loaded = 0;
+		for(int i=0; i<ALLOCATION_QUEUE_SIZE; i++)
+			allocation_queue[i].packet = NULL;
 		req_app_start_time = 0;
 		req_app_task_number = 0;
 		req_app_cluster_id = 0;
@@ -122,6 +168,8 @@ SC_MODULE(app_injector){
 		req_task_id = 0;
 		req_task_allocated_proc = 0;
 		req_task_master_ID = 0;
+		req_task_id_real = 0;
+		req_task_cached = 0;
 		task_static_mapping = 0;
 
 		EA_receive_packet = HEADER;
@@ -145,6 +193,10 @@ SC_MODULE(app_injector){
 		sensitive << clock.pos();
 		sensitive << reset;
 
+		SC_METHOD(allocation_prefetch);
+		sensitive << clock.pos();
+		sensitive << reset;
+
 		SC_METHOD(credit_out_update);
 		sensitive << sig_credit_out;
 
@@ -0,0 +1,406 @@
+/*
+ * traffic_generator.cpp
+ *
+ *  Description: Synthetic traffic generator and sink of the PS NoC. Each instance creates packets following a traffic
+ *  pattern with a Bernoulli process of rate injection_rate/packet_size per cycle. The packets wait into a source queue,
+ *  so the latency (creation to tail delivery) includes the source queuing and saturates with the offered load.
+ *  The sink always has credit and keeps the latency histogram and the accepted flits per source.
+ */
+
+#include "traffic_generator.h"
+
+//This line enables the integration with vhdl
+#ifdef MTI_SYSTEMC
+SC_MODULE_EXPORT(traffic_generator);
+#endif
+
+/**Reads TRAFFIC_CONFIG_FILE. Each line has a key and a value, missing keys keep the default values
+ */
+void traffic_generator::load_config(){
+	string line;
+	char key[64], value[64];
+	unsigned int x, y;
+	ifstream config_file (TRAFFIC_CONFIG_FILE);
+
+	pattern = UNIFORM;
+	injection_rate = 0.1;
+	packet_size = 16;
+	hotspot_index = 0;
+	hotspot_fraction = 20;
+	warmup_cycles = 20000;
+	measure_cycles = 100000;
+
+	if (!config_file.is_open()) {
+		if (pe_index == 0)
+			cout << "WARNING: " << TRAFFIC_CONFIG_FILE << " not found, using the default traffic configuration" << endl;
+		return;
+	}
+
+	while (getline (config_file,line)) {
+
+		if (sscanf(line.c_str(), "%63s %63s", key, value) != 2)
+			continue;
+
+		if (!strcmp(key, "pattern")){
+			if (!strcmp(value, "uniform"))
+				pattern = UNIFORM;
+			else if (!strcmp(value, "transpose"))
+				pattern = TRANSPOSE;
+			else if (!strcmp(value, "bit_complement"))
+				pattern = BIT_COMPLEMENT;
+			else if (!strcmp(value, "hotspot"))
+				pattern = HOTSPOT;
+			else if (!strcmp(value, "neighbor"))
+				pattern = NEIGHBOR;
+			else
+				cout << "ERROR: unknown traffic pattern " << value << ", using uniform" << endl;
+
+		} else if (!strcmp(key, "injection_rate")){
+			injection_rate = atof(value);
+
+		} else if (!strcmp(key, "packet_size")){
+			packet_size = atoi(value);
+			if (packet_size < TRAFFIC_HEADER_SIZE)
+				packet_size = TRAFFIC_HEADER_SIZE;
+
+		} else if (!strcmp(key, "hotspot")){
+			if (sscanf(value, "%u,%u", &x, &y) == 2 && x < N_PE_X && y < N_PE_Y)
+				hotspot_index = y*N_PE_X + x;
+
+		} else if (!strcmp(key, "hotspot_fraction")){
+			hotspot_fraction = atoi(value);
+
+		} else if (!strcmp(key, "warmup_cycles")){
+			warmup_cycles = atoi(value);
+
+		} else if (!strcmp(key, "measure_cycles")){
+			measure_cycles = atoi(value);
+		}
+	}
+
+	config_file.close();
+}
+
+/**xorshift32, each instance has its own sequence
+ */
+unsigned int traffic_generator::next_random(){
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return random_state;
+}
+
+/**Computes the target PE of a new packet according to the traffic pattern
+ * \return The target PE index, -1 when this PE does not inject for the pattern (the target is itself)
+ */
+int traffic_generator::target_index(){
+	unsigned int x, y, tx, ty, target;
+
+	x = pe_index % N_PE_X;
+	y = pe_index / N_PE_X;
+
+	switch (pattern) {
+		case TRANSPOSE:
+			tx = y % N_PE_X;
+			ty = x % N_PE_Y;
+			break;
+		case BIT_COMPLEMENT:
+			tx = N_PE_X - 1 - x;
+			ty = N_PE_Y - 1 - y;
+			break;
+		case NEIGHBOR:
+			tx = (x + 1) % N_PE_X;
+			ty = y;
+			break;
+		case HOTSPOT:
+			if ((next_random() % 100) < hotspot_fraction){
+				tx = hotspot_index % N_PE_X;
+				ty = hotspot_index / N_PE_X;
+				break;
+			}
+			//The remaining packets follow the uniform pattern
+		default:
+			if (N_PE == 1)
+				return -1;
+			do {
+				target = next_random() % N_PE;
+			} while (target == pe_index);
+			tx = target % N_PE_X;
+			ty = target / N_PE_X;
+			break;
+	}
+
+	target = ty*N_PE_X + tx;
+
+	if (target == pe_index)
+		return -1;
+
+	return target;
+}
+
+/**Sequential process
+ * Creates the packets into the source queue following a Bernoulli process
+ */
+void traffic_generator::generate_packet(){
+	int target;
+	bool measuring;
+
+	if (reset.read() == 1)  {
+		current_time = 0;
+		random_state = 2463534242u ^ ((pe_index + 1) * 2654435761u);
+		queue_time.clear();
+		queue_target.clear();
+		created = 0;
+		dropped = 0;
+
+	} else {
+
+		measuring = current_time >= warmup_cycles && current_time < warmup_cycles + measure_cycles;
+
+		if ( ((double) next_random() / 4294967296.0) < (injection_rate / packet_size) ){
+
+			target = target_index();
+
+			if (target >= 0) {
+
+				if (measuring)
+					created++;
+
+				if (queue_time.size() < TRAFFIC_QUEUE_LIMIT){
+					queue_time.push_back(current_time);
+					queue_target.push_back(target);
+				} else if (measuring)
+					dropped++;
+			}
+		}
+
+		current_time++;
+
+		//Only the first instance stops the simulation, the report is written by the test_bench destructor
+		if (pe_index == 0 && current_time == warmup_cycles + measure_cycles + TRAFFIC_DRAIN_CYCLES){
+			cout << "END OF TRAFFIC GENERATION!!!" << endl;
+			sc_stop();
+		}
+	}
+}
+
+/**Sequential process
+ * Sends the packet at the head of the source queue, built flit by flit
+ */
+void traffic_generator::send_packet(){
+	regflit flit;
+	unsigned int target;
+
+	if (reset.read() == 1)  {
+		EA_send_packet = IDLE;
+		tx.write(0);
+	} else {
+
+		switch (EA_send_packet) {
+
+			case IDLE:
+				if (!queue_time.empty() && credit_in.read() == 1){
+					EA_send_packet = SEND_PACKET;
+					p_index = 0;
+				}
+				break;
+
+			case SEND_PACKET:
+
+				if (credit_in.read() == 1){
+
+					if (p_index < packet_size){
+
+						switch (p_index) {
+							case 0:
+								target = queue_target.front();
+								flit = ((target % N_PE_X) << 8) | (target / N_PE_X); //Header: XY address of the target
+								break;
+							case 1:
+								flit = packet_size - 2;
+								break;
+							case 2:
+								flit = TRAFFIC_PACKET;
+								break;
+							case 3:
+								flit = pe_index;
+								break;
+							case 4:
+								flit = queue_time.front();
+								break;
+							default:
+								flit = p_index;
+								break;
+						}
+
+						tx.write(1);
+						data_out.write(flit);
+						p_index++;
+
+					} else {
+						tx.write(0);
+						queue_time.pop_front();
+						queue_target.pop_front();
+						EA_send_packet = IDLE;
+					}
+
+				} else {
+					tx.write(0);
+					EA_send_packet = WAITING_CREDIT;
+				}
+
+				break;
+
+			case WAITING_CREDIT:
+				if (credit_in.read() == 1){
+					tx.write(1);
+					EA_send_packet = SEND_PACKET;
+				}
+				break;
+		}
+	}
+}
+
+/**Sequential process
+ * Consumes the packets delivered by the local port of the router, the sink never holds the credit
+ */
+void traffic_generator::receive_packet(){
+	unsigned long int latency;
+	unsigned int bin;
+	TrafficStats * s;
+
+	if (reset.read() == 1)  {
+		EA_receive_packet = HEADER;
+		credit_out.write(1);
+		memset(stats, 0, sizeof(stats));
+		discarded = 0;
+
+	} else if (rx.read() == 1) {
+
+		switch (EA_receive_packet) {
+
+			case HEADER:
+				EA_receive_packet = PAYLOAD_SIZE;
+				break;
+
+			case PAYLOAD_SIZE:
+				payload_size = data_in.read();
+				rec_flits = 2;
+				rec_service = 0;
+				EA_receive_packet = (payload_size == 0) ? HEADER : SERVICE;
+				break;
+
+			default:
+
+				if (EA_receive_packet == SERVICE){
+					rec_service = data_in.read();
+					EA_receive_packet = SOURCE;
+				} else if (EA_receive_packet == SOURCE){
+					rec_source = data_in.read();
+					EA_receive_packet = CREATION_TIME;
+				} else if (EA_receive_packet == CREATION_TIME){
+					rec_time = data_in.read();
+					EA_receive_packet = PAYLOAD;
+				}
+
+				rec_flits++;
+				payload_size--;
+
+				if (payload_size == 0){
+
+					if (rec_service == TRAFFIC_PACKET && rec_flits >= TRAFFIC_HEADER_SIZE && rec_source < N_PE){
+
+						//Only the packets created inside the measurement window are accounted
+						if (rec_time >= warmup_cycles && rec_time < warmup_cycles + measure_cycles){
+							s = &stats[rec_source];
+							latency = current_time - rec_time;
+							bin = latency / TRAFFIC_HIST_BIN_WIDTH;
+							if (bin >= TRAFFIC_HIST_BINS)
+								bin = TRAFFIC_HIST_BINS - 1;
+
+							s->packets++;
+							s->flits += rec_flits;
+							s->latency_sum += latency;
+							if (latency > s->latency_max)
+								s->latency_max = latency;
+							s->histogram[bin]++;
+						}
+					} else
+						discarded++;
+
+					EA_receive_packet = HEADER;
+				}
+
+				break;
+		}
+	}
+}
+
+/**Writes the traffic report, called at the end of simulation by the test_bench
+ * Per source: created and dropped packets, delivered packets and flits, average and max latency, accepted throughput
+ * (flits/cycle) and latency histogram. The TOTAL line gives one point of the latency-vs-load curve
+ * \param tg Array with the traffic generator of each PE, indexed by PE
+ * \param tg_number Number of traffic generators
+ * \param path Report file path
+ */
+void traffic_report(traffic_generator * tg[], unsigned int tg_number, const char * path){
+	FILE *fp;
+	TrafficStats total_src, total;
+	unsigned long int created = 0, dropped = 0, discarded = 0;
+	double cycles;
+
+	fp = fopen (path, "w");
+
+	if (fp == NULL || tg_number == 0)
+		return;
+
+	cycles = (double) tg[0]->measure_cycles;
+
+	fprintf(fp, "pattern %d injection_rate %.4f packet_size %u warmup_cycles %u measure_cycles %u histogram_bin_width %d\n",
+			tg[0]->pattern, tg[0]->injection_rate, tg[0]->packet_size, tg[0]->warmup_cycles, tg[0]->measure_cycles, TRAFFIC_HIST_BIN_WIDTH);
+
+	memset(&total, 0, sizeof(total));
+
+	for(unsigned int src=0; src<tg_number; src++){
+
+		//Merges the statistics kept by all sinks for this source
+		memset(&total_src, 0, sizeof(total_src));
+		for(unsigned int sink=0; sink<tg_number; sink++){
+			TrafficStats * s = &tg[sink]->stats[src];
+			total_src.packets += s->packets;
+			total_src.flits += s->flits;
+			total_src.latency_sum += s->latency_sum;
+			if (s->latency_max > total_src.latency_max)
+				total_src.latency_max = s->latency_max;
+			for(int b=0; b<TRAFFIC_HIST_BINS; b++)
+				total_src.histogram[b] += s->histogram[b];
+		}
+
+		fprintf(fp, "source %u created %lu dropped %lu delivered %lu flits %lu avg_latency %.2f max_latency %lu accepted_throughput %.4f histogram",
+				src, tg[src]->created, tg[src]->dropped, total_src.packets, total_src.flits,
+				total_src.packets ? (double) total_src.latency_sum / total_src.packets : 0.0, total_src.latency_max, total_src.flits / cycles);
+		for(int b=0; b<TRAFFIC_HIST_BINS; b++)
+			fprintf(fp, " %lu", total_src.histogram[b]);
+		fprintf(fp, "\n");
+
+		created += tg[src]->created;
+		dropped += tg[src]->dropped;
+		discarded += tg[src]->discarded;
+		total.packets += total_src.packets;
+		total.flits += total_src.flits;
+		total.latency_sum += total_src.latency_sum;
+		if (total_src.latency_max > total.latency_max)
+			total.latency_max = total_src.latency_max;
+		for(int b=0; b<TRAFFIC_HIST_BINS; b++)
+			total.histogram[b] += total_src.histogram[b];
+	}
+
+	fprintf(fp, "TOTAL created %lu dropped %lu delivered %lu discarded %lu avg_latency %.2f max_latency %lu accepted_throughput %.4f histogram",
+			created, dropped, total.packets, discarded, total.packets ? (double) total.latency_sum / total.packets : 0.0,
+			total.latency_max, total.flits / cycles / tg_number);
+	for(int b=0; b<TRAFFIC_HIST_BINS; b++)
+		fprintf(fp, " %lu", total.histogram[b]);
+	fprintf(fp, "\n");
+
+	fclose(fp);
+}
@@ -0,0 +1,149 @@
+/*
+ * traffic_generator.h
+ *
+ *  Description: Synthetic traffic generator and sink used to characterize the PS NoC without kernel and software effects.
+ *  When TRAFFIC_GENERATOR is enabled into memphis_pkg.h each PE has its CPU clock held and the local port of the PS router
+ *  is connected to an instance of this module in place of the DMNI.
+ */
+
+
+#ifndef PERIPHERALS_TRAFFIC_GENERATOR_H_
+#define PERIPHERALS_TRAFFIC_GENERATOR_H_
+
+
+#include <systemc.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <deque>
+#include "../standards.h"
+
+using namespace std;
+
+#define TRAFFIC_PACKET				0x00000700 	//Service of the synthetic packets, the other packets are discarded by the sink
+#define TRAFFIC_CONFIG_FILE			"../traffic_generator.cfg" //Generated by hw_builder.py, read at the simulation start
+#define TRAFFIC_HEADER_SIZE			5			//header, payload size, service, source, creation time
+#define TRAFFIC_HIST_BINS			64			//Latency histogram bins, the last one accumulates the latencies out of range
+#define TRAFFIC_HIST_BIN_WIDTH		16			//cycles
+#define TRAFFIC_QUEUE_LIMIT			100000		//Max packets waiting into the source queue, the new ones are dropped
+#define TRAFFIC_DRAIN_CYCLES		20000		//Cycles after the measurement window before the simulation stops
+
+//Traffic patterns
+#define UNIFORM						0
+#define TRANSPOSE					1
+#define BIT_COMPLEMENT				2
+#define HOTSPOT						3
+#define NEIGHBOR					4
+
+//Per source statistics, kept by each sink for the packets created inside the measurement window
+typedef struct {
+	unsigned long int packets;
+	unsigned long int flits;
+	unsigned long int latency_sum;
+	unsigned long int latency_max;
+	unsigned long int histogram[TRAFFIC_HIST_BINS];
+} TrafficStats;
+
+SC_MODULE(traffic_generator){
+
+	//Ports
+	sc_in <bool > 		clock;
+	sc_in <bool > 		reset;
+
+	sc_in <bool > 		rx;
+	sc_in<regflit > 	data_in;
+	sc_out<bool > 		credit_out;
+
+	sc_out <bool > 		tx;
+	sc_out<regflit > 	data_out;
+	sc_in<bool > 		credit_in;
+
+	//Functions
+	void load_config();
+	unsigned int next_random();
+	int target_index();
+
+	//Sequential logic
+	void generate_packet();
+	void send_packet();
+	void receive_packet();
+
+	//FSM
+	enum FSM_send_packet{IDLE, SEND_PACKET, WAITING_CREDIT};
+	enum FSM_receive_packet{HEADER, PAYLOAD_SIZE, SERVICE, SOURCE, CREATION_TIME, PAYLOAD};
+
+	enum FSM_send_packet 		EA_send_packet;
+	enum FSM_receive_packet 	EA_receive_packet;
+
+	unsigned int pe_index;
+	unsigned int current_time;
+	unsigned int random_state;
+
+	//Configuration, see TRAFFIC_CONFIG_FILE
+	int 		 pattern;
+	double 		 injection_rate;	//Offered load in flits/cycle
+	unsigned int packet_size;		//Flits, including the header and the payload size
+	int 		 hotspot_index;
+	unsigned int hotspot_fraction;	//Percentage of the packets sent to the hotspot
+	unsigned int warmup_cycles;
+	unsigned int measure_cycles;
+
+	//Source queue, stores the creation time and target of the packets not sent yet
+	deque<unsigned int> queue_time;
+	deque<int> 			queue_target;
+	unsigned int 		p_index;
+
+	//Source statistics
+	unsigned long int 	created;		//Packets created inside the measurement window
+	unsigned long int 	dropped;		//Packets dropped due to TRAFFIC_QUEUE_LIMIT
+
+	//Used inside EA_receive_packet
+	unsigned int 		payload_size;
+	unsigned int 		rec_service;
+	unsigned int 		rec_source;
+	unsigned int 		rec_time;
+	unsigned int 		rec_flits;
+	unsigned long int 	discarded;		//Packets which are not TRAFFIC_PACKET, e.g., the boot code sent by the app injector
+
+	//Sink statistics indexed by source PE
+	TrafficStats stats[N_PE];
+
+	SC_HAS_PROCESS(traffic_generator);
+	traffic_generator (sc_module_name name_, unsigned int pe_index_ = 0) :
+		sc_module(name_), pe_index(pe_index_) {
+
+		current_time = 0;
+		p_index = 0;
+		created = 0;
+		dropped = 0;
+		payload_size = 0;
+		rec_service = 0;
+		rec_source = 0;
+		rec_time = 0;
+		rec_flits = 0;
+		discarded = 0;
+		memset(stats, 0, sizeof(stats));
+
+		load_config();
+
+		EA_send_packet = IDLE;
+		EA_receive_packet = HEADER;
+
+		SC_METHOD(generate_packet);
+		sensitive << clock.pos();
+		sensitive << reset;
+
+		SC_METHOD(send_packet);
+		sensitive << clock.pos();
+		sensitive << reset;
+
+		SC_METHOD(receive_packet);
+		sensitive << clock.pos();
+		sensitive << reset;
+	}
+
+};
+
+void traffic_report(traffic_generator * [], unsigned int, const char *);
+
+#endif /* PERIPHERALS_TRAFFIC_GENERATOR_H_ */
@@ -23,6 +23,47 @@
 #define METADEFLIT (TAM_FLIT/2)
 #define QUARTOFLIT (TAM_FLIT/4)
 
+//NoC topology, TORUS_TOPOLOGY is generated into memphis_pkg.h (0 - 2D mesh, 1 - 2D torus)
+#ifndef TORUS_TOPOLOGY
+#define TORUS_TOPOLOGY 0
+#endif
+
+//PS header flit priority (bits TAM_FLIT-1..TAM_FLIT-3 are used by the IO routing)
+#define PRIORITY_BIT 				(TAM_FLIT-4)
+#define PRIORITY_STARVATION_LIMIT	4 //Max consecutive priority grants while a best-effort header is waiting
+
+//Hardware message request table, MSG_REQUEST_TABLE is generated into memphis_pkg.h (0 - disabled, 1 - enabled)
+#ifndef MSG_REQUEST_TABLE
+#define MSG_REQUEST_TABLE 0
+#endif
+#define MSG_REQUEST_BIT 			(TAM_FLIT-5) //Header flit bit of the MESSAGE_REQUEST packets handled by the table
+#define MSG_REQUEST_TABLE_SIZE		8
+#define MSG_REQUEST_TABLE_TASKS		8 //Must be >= MAX_LOCAL_TASKS
+#define MSG_REQUEST_FREE_TASK		0xFFFF
+#define MATCH_EXACT					0
+#define MATCH_PRODUCER				1
+#define MATCH_ORPHAN				2
+
+//Synthetic traffic generator, TRAFFIC_GENERATOR is generated into memphis_pkg.h (0 - disabled, 1 - the CPU is held and
+//the local PS port of each PE is driven by peripherals/traffic_generator)
+#ifndef TRAFFIC_GENERATOR
+#define TRAFFIC_GENERATOR 0
+#endif
+
+//Performance counters, 32-bit wrapping counters read by the kernel through PERF_SELECT/PERF_VALUE
+#define PERF_PAGES					(MEMORY_SIZE_BYTES/PAGE_SIZE_BYTES)
+#define PERF_INSTRUCTIONS			0 //Index: page. Instructions retired
+#define PERF_CYCLES					1 //Index: page. Cycles with the CPU clock running
+#define PERF_STALLS					2 //Index: page. Cycles with mem_pause asserted
+#define PERF_INTERRUPTS				3 //Index: page. Interrupts taken while the page was running
+#define PERF_DMNI_SENT				4 //Index: subnet. Bytes sent by the DMNI
+#define PERF_DMNI_RECEIVED			5 //Index: subnet. Bytes received by the DMNI
+#define PERF_LINK_UTILIZATION		6 //Index: PS router port. Output link utilization (%) in the last ROUTER_MONITOR_WINDOW
+#define PERF_BUFFER_OCCUPANCY		7 //Index: PS router port. Average input buffer occupancy (%) in the last ROUTER_MONITOR_WINDOW
+#define ROUTER_MONITOR_WINDOW		10000 //cycles
+
+#define DVFS_LEVELS					4 //CPU clock dividers 1, 2, 4 and 8, level 0 is the full clock
+
 	// Memory map constants.
 #define DEBUG 					0x20000000
 #define IRQ_MASK 				0x20000010
@@ -42,8 +83,19 @@
 #define DMNI_MEM_ADDR2 			0x20000220
 #define DMNI_MEM_SIZE2 			0x20000224
 #define DMNI_OP 				0x20000230
+#define DMNI_RING_BASE			0x20000234
+#define DMNI_RING_SIZE			0x20000238
+#define DMNI_RING_HEAD			0x2000023C
+#define DMNI_RING_DONE			0x20000240
+#define DMNI_RING_ACK			0x20000244
+#define DMNI_RECV_COALESCE		0x20000248
+#define DMNI_RECV_PENDING		0x2000024C
 #define DMNI_SEND_ACTIVE 		0x20000250
+#define DMNI_COPY_ACTIVE		0x20000254
 #define DMNI_RECEIVE_ACTIVE 	0x20000260
+#define DMNI_COPY_SRC			0x20000264
+#define DMNI_COPY_DST			0x20000268
+#define DMNI_COPY_SIZE			0x2000026C
 
 #define SCHEDULING_REPORT		0x20000270
 #define ADD_PIPE_DEBUG			0x20000280
@@ -59,9 +111,24 @@
 
 #define SLACK_TIME_MONITOR		0x20000370
 
+//DVFS, the CPU clock is enabled once every 2^level PE clock cycles
+#define DVFS_LEVEL				0x20000380
+
 //Kernel pending service FIFO
 #define PENDING_SERVICE_INTR	0x20000400
 
+//Hardware message request table
+#define MSG_REQUEST_TASK			0x20000500
+#define MSG_REQUEST_MATCH			0x20000504
+#define MSG_REQUEST_MATCH_PRODUCER	0x20000508
+#define MSG_REQUEST_MATCH_ORPHAN	0x2000050C
+#define MSG_REQUEST_RESULT			0x20000510
+#define MSG_REQUEST_RESULT_TASKS	0x20000514
+
+//Performance counters, PERF_SELECT receives (counter << 8 | index) and PERF_VALUE returns the selected counter
+#define PERF_SELECT					0x20000600
+#define PERF_VALUE					0x20000604
+
 #define SLACK_MONITOR_WINDOW 	100000
 
 //DMNI config code
@@ -71,6 +138,22 @@
 #define CODE_MEM_ADDR2			4
 #define CODE_MEM_SIZE2			5
 #define CODE_OP					6
+#define CODE_RING_BASE			7
+#define CODE_RING_SIZE			8
+#define CODE_RING_HEAD			9
+#define CODE_RING_ACK			10
+#define CODE_RECV_COALESCE		11
+#define CODE_COPY_SRC			12
+#define CODE_COPY_DST			13
+#define CODE_COPY_SIZE			14
+
+//DMNI send descriptor ring: each descriptor is {address, size} in memory
+#define RING_DESCRIPTOR_SIZE	8 //bytes
+//DMNI PS receive FIFO, holds several packets so one interrupt can drain them (must be power of two)
+#define PS_RECV_BUFFER			64 //flits
+
+#define IRQ_DMNI_RING_BIT		13 //irq_status bit, above the subnets bits (4 to 12)
+#define IRQ_MSG_REQUEST_BIT		14 //irq_status bit, request to a non local producer stored in the message request table
 
 #define MEMORY_WORD_SIZE	4
 
@@ -96,9 +179,9 @@ typedef sc_uint<(3*NPORT)> 		reg_mux;
 
 
 //Circuit-switching macros
-#define CS_SUBNETS_NUMBER 	SUBNETS_NUMBER-1
+#define CS_SUBNETS_NUMBER 	(SUBNETS_NUMBER-1)
 #define PS_NET_INDEX 		CS_SUBNETS_NUMBER
-#define MAX_CS_SHIFT		32/TAM_CS_FLIT
+#define MAX_CS_SHIFT		(32/TAM_CS_FLIT)
 
 //Circuit-switching types
 typedef sc_uint<TAM_CS_FLIT > 		regCSflit;
@@ -27,13 +27,13 @@ SC_MODULE(test_bench) {
 	sc_signal< bool >	clock;
 	sc_signal< bool >	reset;
 		
-	//IO signals connecting App Injector and Memphis
-	sc_signal<bool>		memphis_injector_tx;
-	sc_signal<bool>		memphis_injector_credit_i;
-	sc_signal<regflit> 	memphis_injector_data_out;
-	sc_signal<bool>		memphis_injector_rx;
-	sc_signal<bool>		memphis_injector_credit_o;
-	sc_signal<regflit>	memphis_injector_data_in;
+	//IO signals connecting App Injectors and Memphis
+	sc_signal<bool>		memphis_injector_tx			[APP_INJECTOR_NUMBER];
+	sc_signal<bool>		memphis_injector_credit_i	[APP_INJECTOR_NUMBER];
+	sc_signal<regflit> 	memphis_injector_data_out	[APP_INJECTOR_NUMBER];
+	sc_signal<bool>		memphis_injector_rx			[APP_INJECTOR_NUMBER];
+	sc_signal<bool>		memphis_injector_credit_o	[APP_INJECTOR_NUMBER];
+	sc_signal<regflit>	memphis_injector_data_in	[APP_INJECTOR_NUMBER];
 
 	//Create the signals of your IO component here:
 
@@ -43,7 +43,7 @@ SC_MODULE(test_bench) {
 	void resetGenerator();
 	
 	memphis * MPSoC;
-	app_injector * io_app;
+	app_injector * io_app[APP_INJECTOR_NUMBER];
 
 	char aux[255];
 	FILE *fp;
@@ -57,23 +57,31 @@ SC_MODULE(test_bench) {
 		MPSoC = new memphis("Memphis");
 		MPSoC->clock(clock);
 		MPSoC->reset(reset);
-		MPSoC->memphis_app_injector_tx(memphis_injector_tx);
-		MPSoC->memphis_app_injector_credit_i(memphis_injector_credit_i);
-		MPSoC->memphis_app_injector_data_out(memphis_injector_data_out);
-		MPSoC->memphis_app_injector_rx(memphis_injector_rx);
-		MPSoC->memphis_app_injector_credit_o(memphis_injector_credit_o);
-		MPSoC->memphis_app_injector_data_in(memphis_injector_data_in);
-
-
-		io_app = new app_injector("App_Injector");
-		io_app->clock(clock);
-		io_app->reset(reset);
-		io_app->rx(memphis_injector_tx);
-		io_app->data_in(memphis_injector_data_out);
-		io_app->credit_out(memphis_injector_credit_i);
-		io_app->tx(memphis_injector_rx);
-		io_app->data_out(memphis_injector_data_in);
-		io_app->credit_in(memphis_injector_credit_o);
+
+		for (int a = 0; a < APP_INJECTOR_NUMBER; a++){
+			MPSoC->memphis_app_injector_tx[a](memphis_injector_tx[a]);
+			MPSoC->memphis_app_injector_credit_i[a](memphis_injector_credit_i[a]);
+			MPSoC->memphis_app_injector_data_out[a](memphis_injector_data_out[a]);
+			MPSoC->memphis_app_injector_rx[a](memphis_injector_rx[a]);
+			MPSoC->memphis_app_injector_credit_o[a](memphis_injector_credit_o[a]);
+			MPSoC->memphis_app_injector_data_in[a](memphis_injector_data_in[a]);
+
+			//The first injector keeps the name App_Injector, which is used by the wave scripts
+			if (a == 0)
+				sprintf(aux, "App_Injector");
+			else
+				sprintf(aux, "App_Injector_%d", a);
+
+			io_app[a] = new app_injector(aux, a, APP_INJECTOR_NUMBER);
+			io_app[a]->clock(clock);
+			io_app[a]->reset(reset);
+			io_app[a]->rx(memphis_injector_tx[a]);
+			io_app[a]->data_in(memphis_injector_data_out[a]);
+			io_app[a]->credit_out(memphis_injector_credit_i[a]);
+			io_app[a]->tx(memphis_injector_rx[a]);
+			io_app[a]->data_out(memphis_injector_data_in[a]);
+			io_app[a]->credit_in(memphis_injector_credit_o[a]);
+		}
 
 		//Instantiate your IO component  here
 		//...
@@ -186,6 +194,29 @@ SC_MODULE(test_bench) {
 			fclose (fp);
 
 		}
+
+		//DVFS: time (PE cycles), CPU cycles and instructions at each level. The energy of a level scales with its V^2
+		for(int j=0;j<N_PE;j++){
+
+			sprintf(aux, "log_energy.txt");
+			fp = fopen (aux, "a");
+
+			sprintf(aux, "DVFS %d ", j);
+			fprintf(fp,"%s",aux);
+			for(int l=0; l<DVFS_LEVELS; l++){
+				sprintf(aux, "level_%d cycles %lu cpu_cycles %lu instructions %lu ", l, MPSoC-> PE[j]->dvfs_cycles[l], MPSoC-> PE[j]->dvfs_cpu_cycles[l], MPSoC-> PE[j]->dvfs_inst[l]);
+				fprintf(fp,"%s",aux);
+			}
+			fprintf(fp,"\n");
+			fclose (fp);
+		}
+
+#if TRAFFIC_GENERATOR
+		traffic_generator * tg[N_PE];
+		for(int j=0;j<N_PE;j++)
+			tg[j] = MPSoC-> PE[j]->traffic;
+		traffic_report(tg, N_PE, "traffic_report.txt");
+#endif
 					
 	}
 	private:
@@ -41,6 +41,8 @@ signal ask: std_logic := '0';
 signal sel,prox: integer range 0 to (NPORT-1) := 0;
 signal incoming: reg3 := (others=> '0');
 signal header : regflit := (others=> '0');
+signal priority_grant: std_logic := '0';
+signal starvation_count: integer range 0 to PRIORITY_STARVATION_LIMIT := 0;
 
 -- sinais do controle
 signal dirx,diry: integer range 0 to (NPORT-1) := 0;
@@ -56,40 +58,36 @@ begin
         incoming <= CONV_VECTOR(sel);
         header <= data(CONV_INTEGER(incoming));
 
-        process(sel,h)
+        -- priority-aware round-robin: headers with PRIORITY_BIT set are served first, after
+        -- PRIORITY_STARVATION_LIMIT consecutive priority grants a waiting best-effort header is served once
+        process(sel,h,data,starvation_count)
+                variable pending_priority, pending_normal, want_priority: std_logic;
+                variable p_idx: integer range 0 to (NPORT-1);
         begin
-                case sel is
-                        when LOCAL=>
-                                if h(EAST)='1' then prox<=EAST;
-                                elsif h(WEST)='1' then  prox<=WEST;
-                                elsif h(NORTH)='1' then prox<=NORTH;
-                                elsif h(SOUTH)='1' then prox<=SOUTH;
-                                else prox<=LOCAL; end if;
-                        when EAST=>
-                                if h(WEST)='1' then prox<=WEST;
-                                elsif h(NORTH)='1' then prox<=NORTH;
-                                elsif h(SOUTH)='1' then prox<=SOUTH;
-                                elsif h(LOCAL)='1' then prox<=LOCAL;
-                                else prox<=EAST; end if;
-                        when WEST=>
-                                if h(NORTH)='1' then prox<=NORTH;
-                                elsif h(SOUTH)='1' then prox<=SOUTH;
-                                elsif h(LOCAL)='1' then prox<=LOCAL;
-                                elsif h(EAST)='1' then prox<=EAST;
-                                else prox<=WEST; end if;
-                        when NORTH=>
-                                if h(SOUTH)='1' then prox<=SOUTH;
-                                elsif h(LOCAL)='1' then prox<=LOCAL;
-                                elsif h(EAST)='1' then prox<=EAST;
-                                elsif h(WEST)='1' then prox<=WEST;
-                                else prox<=NORTH; end if;
-                        when SOUTH=>
-                                if h(LOCAL)='1' then prox<=LOCAL;
-                                elsif h(EAST)='1' then prox<=EAST;
-                                elsif h(WEST)='1' then prox<=WEST;
-                                elsif h(NORTH)='1' then prox<=NORTH;
-                                else prox<=SOUTH; end if;
-                end case;
+                pending_priority := '0';
+                pending_normal := '0';
+                for i in 0 to NPORT-1 loop
+                        if h(i)='1' then
+                                if data(i)(PRIORITY_BIT)='1' then pending_priority := '1';
+                                else pending_normal := '1'; end if;
+                        end if;
+                end loop;
+
+                if pending_priority='1' and not (pending_normal='1' and starvation_count=PRIORITY_STARVATION_LIMIT) then
+                        want_priority := '1';
+                else
+                        want_priority := '0';
+                end if;
+
+                priority_grant <= want_priority and pending_normal;
+
+                prox <= sel;
+                for i in NPORT downto 1 loop
+                        p_idx := (sel + i) mod NPORT;
+                        if h(p_idx)='1' and data(p_idx)(PRIORITY_BIT)=want_priority then
+                                prox <= p_idx;
+                        end if;
+                end loop;
         end process;
 
 
@@ -188,6 +186,7 @@ begin
                                 -- Zera vari�veis
                                 when S0 =>
                                         sel <= 0;
+                                        starvation_count <= 0;
                                         ack_h <= (others => '0');
                                         auxfree <= (others=> '1');
                                         sender_ant <= (others=> '0');
@@ -199,6 +198,11 @@ begin
                                 -- Seleciona quem tera direito a requisitar roteamento
                                 when S2=>
                                         sel <= prox;
+                                        if priority_grant='1' then
+                                                starvation_count <= starvation_count + 1;
+                                        else
+                                                starvation_count <= 0;
+                                        end if;
                                 -- Estabelece a conex�o com a porta LOCAL
                                 when S4 =>
                                         source(CONV_INTEGER(incoming)) <= CONV_VECTOR(LOCAL);
@@ -102,6 +102,10 @@ package standards is
         constant METADEFLIT : integer range 1 to 32 := (TAM_FLIT/2);
         constant QUARTOFLIT : integer range 1 to 16 := (TAM_FLIT/4);
 
+        -- header flit priority bit (TAM_FLIT-1 downto TAM_FLIT-3 are used by the IO routing)
+        constant PRIORITY_BIT : integer range 0 to 63 := (TAM_FLIT-4);
+        constant PRIORITY_STARVATION_LIMIT : integer range 1 to 7 := 4;
+
 ---------------------------------------------------------
 -- CONSTANTS DEPENDENTES DA PROFUNDIDADE DA FILA
 ---------------------------------------------------------
@@ -21,9 +21,25 @@ unsigned int global_inst = 0;			//!<Global CPU instructions counter
 unsigned int net_address;				//!<Global net_address
 unsigned int schedule_after_syscall;	//!< Signals the syscall function (referenced in assembly - HAL_kernel_asm) to call the scheduler after the syscall
 
+#if DMNI_SEND_RING
+volatile unsigned int send_ring[SEND_RING_SIZE*2];	//!<PS send descriptors, each one is a pair {address, size}
+unsigned int send_ring_head;						//!<Number of descriptors pushed to DMNI, free running counter
+#endif
+
 
 void init_HAL(){
 	net_address = HAL_get_core_addr();
+
+#if DMNI_SEND_RING
+	send_ring_head = 0;
+	HAL_set_dmni_net(PS_SUBNET);
+	HAL_set_dmni_ring_base((unsigned int) send_ring);
+	HAL_set_dmni_ring_size(SEND_RING_SIZE);
+#endif
+
+#if DMNI_RECV_COALESCING
+	HAL_set_dmni_recv_coalesce((RECV_COALESCE_PACKETS << 24) | RECV_COALESCE_WINDOW);
+#endif
 }
 
 inline void HAL_release_waiting_task(TCB * tcb_ptr){
@@ -31,6 +47,7 @@ inline void HAL_release_waiting_task(TCB * tcb_ptr){
 	tcb_ptr->reg[0] = 1;
 	//Set to ready to execute into scheduler
 	tcb_ptr->scheduling_ptr->waiting_msg = 0;
+	update_ready_bitmaps(tcb_ptr->scheduling_ptr);
 }
 
 /*Set the HAL_kernel_asm to calls the scheduler after a system call execution
@@ -99,6 +116,13 @@ inline unsigned int DMNI_read_data_CS(unsigned int initial_address, unsigned int
  */
 void DMNI_send_data(unsigned int initial_address, unsigned int dmni_msg_size,  unsigned int subnet_nr){
 
+#if DMNI_SEND_RING
+	if (subnet_nr == PS_SUBNET){
+		DMNI_send_ring_push(initial_address, dmni_msg_size, 0, 0);
+		return;
+	}
+#endif
+
 	while (HAL_is_send_active(subnet_nr));
 
 	HAL_set_dmni_net(subnet_nr);
@@ -110,6 +134,105 @@ void DMNI_send_data(unsigned int initial_address, unsigned int dmni_msg_size,  u
 
 
 
+#if DMNI_SEND_RING
+/**Gets the number of PS descriptors completely transmitted by the DMNI
+ * \return Free running counter of sent descriptors
+ */
+unsigned int DMNI_send_ring_done(){
+
+	HAL_set_dmni_net(PS_SUBNET);
+
+	return HAL_get_dmni_ring_done();
+}
+
+/**Gets the number of free PS descriptors
+ * \return Descriptors that can be pushed without waiting
+ */
+unsigned int DMNI_send_ring_free(){
+
+	return SEND_RING_SIZE - (send_ring_head - DMNI_send_ring_done());
+}
+
+/**Acknowledges the sent descriptors, the IRQ_DMNI_RING interrupt stays up while done and ack differ
+ * \param done Free running counter of sent descriptors already handled by the kernel
+ */
+void DMNI_send_ring_ack(unsigned int done){
+
+	HAL_set_dmni_net(PS_SUBNET);
+	HAL_set_dmni_ring_ack(done);
+}
+
+/**Pushes one packet into the PS send ring. The DMNI transmits it while the kernel keeps running.
+ * The packet is formed by up to two memory segments, typically the service header and the payload
+ * \param address Initial memory address of the first segment
+ * \param size Size of the first segment, represented in memory words of 32 bits
+ * \param address2 Initial memory address of the second segment
+ * \param size2 Size of the second segment, 0 when there is no second segment
+ * \return Sequence number of the packet, the packet is sent when DMNI_send_ring_done() reaches it
+ */
+unsigned int DMNI_send_ring_push(unsigned int address, unsigned int size, unsigned int address2, unsigned int size2){
+
+	unsigned int needed, index;
+
+	needed = (size2 > 0) ? 2 : 1;
+
+	//Waits room for all segments, so that the DMNI fetches the whole packet without a gap
+	while ( (send_ring_head + needed - DMNI_send_ring_done()) > SEND_RING_SIZE );
+
+	index = (send_ring_head % SEND_RING_SIZE) * 2;
+	send_ring[index] = address;
+	send_ring[index+1] = size;
+	send_ring_head++;
+
+	if (needed == 2){
+		index = (send_ring_head % SEND_RING_SIZE) * 2;
+		send_ring[index] = address2;
+		send_ring[index+1] = size2;
+		send_ring_head++;
+	}
+
+	HAL_set_dmni_net(PS_SUBNET);
+	HAL_set_dmni_ring_head(send_ring_head);
+
+	return send_ring_head;
+}
+#endif
+
+/**Copies a memory block to another one, used to deliver the messages between tasks of the same PE.
+ * With DMNI_LOCAL_COPY the DMNI copies while the kernel keeps running, the source must not be written and
+ * the destination must not be read before DMNI_copy_wait(). Otherwise the CPU copies before returning
+ * \param dst_address Initial memory address of the destination
+ * \param src_address Initial memory address of the source
+ * \param size Data size, is represented in memory word of 32 bits
+ */
+void DMNI_copy_start(unsigned int dst_address, unsigned int src_address, unsigned int size){
+
+#if DMNI_LOCAL_COPY
+	while (HAL_is_copy_active());
+
+	if (size == 0)
+		return;
+
+	HAL_set_dmni_copy_src(src_address);
+	HAL_set_dmni_copy_dst(dst_address);
+	HAL_set_dmni_copy_size(size);
+#else
+	unsigned int * dst = (unsigned int *) dst_address;
+	unsigned int * src = (unsigned int *) src_address;
+
+	for(int i=0; i<size; i++)
+		dst[i] = src[i];
+#endif
+}
+
+/**Waits the end of the last DMNI_copy_start()
+ */
+void DMNI_copy_wait(){
+#if DMNI_LOCAL_COPY
+	while (HAL_is_copy_active());
+#endif
+}
+
 /**Function that abstracts the process to configure the CS routers table,
  * This function configures the IRT and ORT CS_router tables
  * \param input_port Input port number [0-4]
@@ -158,6 +281,20 @@ unsigned int HAL_interrupt_mask_set(unsigned int Mask) {
     return mask;
 }
 
+#if PERF_COUNTERS
+/**Reads a hardware performance counter
+ * \param counter Counter ID (PERF_INSTRUCTIONS, PERF_CYCLES, ...)
+ * \param index Page of the per page counters or subnet of the DMNI counters
+ * \return Counter value, it wraps at 32 bits
+ */
+unsigned int HAL_get_perf_counter(unsigned int counter, unsigned int index){
+
+	HAL_set_perf_select(counter, index);
+
+	return HAL_get_perf_value();
+}
+#endif
+
 /**Print the string in the text file log
  * \param string array of chars
  * \return The int return is only to avoid a build-in warning
@@ -36,8 +36,19 @@ extern unsigned int net_address;
 #define DMNI_MEM_ADDR2			0x20000220
 #define DMNI_MEM_SIZE2			0x20000224
 #define DMNI_OP					0x20000230
+#define DMNI_RING_BASE			0x20000234
+#define DMNI_RING_SIZE			0x20000238
+#define DMNI_RING_HEAD			0x2000023C
+#define DMNI_RING_DONE			0x20000240
+#define DMNI_RING_ACK			0x20000244
+#define DMNI_RECV_COALESCE		0x20000248
+#define DMNI_RECV_PENDING		0x2000024C
 #define DMNI_SEND_STATUS	  	0x20000250
+#define DMNI_COPY_STATUS		0x20000254
 #define DMNI_RECEIVE_STATUS		0x20000260
+#define DMNI_COPY_SRC			0x20000264
+#define DMNI_COPY_DST			0x20000268
+#define DMNI_COPY_SIZE			0x2000026C
 #define SCHEDULING_REPORT		0x20000270
 #define ADD_PIPE_DEBUG			0x20000280
 #define REM_PIPE_DEBUG			0x20000285
@@ -50,8 +61,21 @@ extern unsigned int net_address;
 #define HANDLE_CS_REQUEST		0x20000330
 /* Slack Timer Monitor MMR addresses */
 #define SLACK_TIME_MONITOR		0x20000370
+/* DVFS, the CPU clock is enabled once every 2^level cycles. DVFS is generated into kernel_pkg.h */
+#define DVFS_LEVEL				0x20000380
+#define DVFS_LEVELS				4
 /* Kernel pending service FIFO */
 #define PENDING_SERVICE_INTR	0x20000400
+/* Hardware message request table, MSG_REQUEST_TABLE is generated into kernel_pkg.h */
+#define MSG_REQUEST_TASK			0x20000500
+#define MSG_REQUEST_MATCH			0x20000504
+#define MSG_REQUEST_MATCH_PRODUCER	0x20000508
+#define MSG_REQUEST_MATCH_ORPHAN	0x2000050C
+#define MSG_REQUEST_RESULT			0x20000510
+#define MSG_REQUEST_RESULT_TASKS	0x20000514
+/* Performance counters, PERF_COUNTERS is generated into kernel_pkg.h */
+#define PERF_SELECT				0x20000600
+#define PERF_VALUE				0x20000604
 /* Debugging MMR addresses */
 #define INTERRUPTION			0x10000
 #define SCHEDULER				0x40000
@@ -68,6 +92,9 @@ extern unsigned int net_address;
 /*Used to filter the IRQ status with only the value of PS interruption*/
 #define IRQ_PS					(IRQ_INIT_NOC << (SUBNETS_NUMBER-1) )
 
+/*Used to filter the IRQ status with the interruptions of all subnets*/
+#define IRQ_NOC					(((1 << SUBNETS_NUMBER) - 1) * IRQ_INIT_NOC)
+
 /*Used by DAPE to define the application window period */
 #define APL_WINDOW				1000000
 
@@ -87,12 +114,32 @@ extern unsigned int net_address;
 /* Defines the number where Packet-Switching subnet is refered in MMR*/
 #define PS_SUBNET 				(SUBNETS_NUMBER-1)
 
+/* Number of {address, size} descriptors of the PS send ring, DMNI_SEND_RING is generated into kernel_pkg.h */
+#define SEND_RING_SIZE			16
+
+/* PS receive interrupt coalescing, DMNI_RECV_COALESCING is generated into kernel_pkg.h.
+ * The interrupt is raised after RECV_COALESCE_PACKETS headers or RECV_COALESCE_WINDOW cycles after the first one */
+#define RECV_COALESCE_PACKETS	4
+#define RECV_COALESCE_WINDOW	256
+
+/* Performance counter IDs. Counters wrap at 32 bits, the software works with the difference between two reads */
+#define PERF_INSTRUCTIONS		0 //indexed by page
+#define PERF_CYCLES				1 //indexed by page, cycles with the CPU clock running
+#define PERF_STALLS				2 //indexed by page
+#define PERF_INTERRUPTS			3 //indexed by page
+#define PERF_DMNI_SENT			4 //indexed by subnet, bytes
+#define PERF_DMNI_RECEIVED		5 //indexed by subnet, bytes
+#define PERF_LINK_UTILIZATION	6 //indexed by PS router port, percentage of the last router monitoring window
+#define PERF_BUFFER_OCCUPANCY	7 //indexed by PS router port, percentage of the last router monitoring window
+
 /*********** IRQ Interrupt bits **************/
 #define IRQ_SCHEDULER			0x01 //bit 0
 #define IRQ_PENDING_SERVICE		0x02 //bit 1
 #define IRQ_SLACK_TIME			0x04 //bit 2
 #define IRQ_CS_REQUEST			0x08 //bit 3
 #define IRQ_INIT_NOC			0x10 //bit 4
+#define IRQ_DMNI_RING			0x2000 //bit 13 - send ring completion, after the subnets bits
+#define IRQ_MSG_REQUEST			0x4000 //bit 14 - message request table holds a request to a non local producer
 
 
 
@@ -103,7 +150,14 @@ extern unsigned int net_address;
 #define	HAL_get_core_addr()				(*(volatile unsigned int*)(NET_ADDRESS))
 #define HAL_is_send_active(subnet) 		((*(volatile unsigned int*)(DMNI_SEND_STATUS)) & (1 << subnet))
 #define HAL_is_receive_active(subnet) 	((*(volatile unsigned int*)(DMNI_RECEIVE_STATUS)) & (1 << subnet))
+#define HAL_is_copy_active() 			(*(volatile unsigned int*)(DMNI_COPY_STATUS))
 #define HAL_get_CS_request()			(*(volatile unsigned int*)(READ_CS_REQUEST))
+#define HAL_get_dmni_ring_done()		(*(volatile unsigned int*)(DMNI_RING_DONE))
+#define HAL_get_dmni_recv_pending()		(*(volatile unsigned int*)(DMNI_RECV_PENDING))
+#define HAL_get_msg_request_result()	(*(volatile unsigned int*)(MSG_REQUEST_RESULT))
+#define HAL_get_msg_request_tasks()		(*(volatile unsigned int*)(MSG_REQUEST_RESULT_TASKS))
+#define HAL_get_perf_value()			(*(volatile unsigned int*)(PERF_VALUE))
+#define HAL_get_dvfs_level()			(*(volatile unsigned int*)(DVFS_LEVEL))
 
 /*MMR write functions*/
 #define HAL_set_irq_mask(mask)			*(volatile unsigned int*)(IRQ_MASK)=(mask)
@@ -114,16 +168,30 @@ extern unsigned int net_address;
 #define HAL_set_dmni_mem_size(size)		*(volatile unsigned int*)(DMNI_MEM_SIZE)=(size)
 #define HAL_set_dmni_mem_addr2(addr)	*(volatile unsigned int*)(DMNI_MEM_ADDR2)=(addr)
 #define HAL_set_dmni_mem_size2(size)	*(volatile unsigned int*)(DMNI_MEM_SIZE2)=(size)
+#define HAL_set_dmni_ring_base(addr)	*(volatile unsigned int*)(DMNI_RING_BASE)=(addr)
+#define HAL_set_dmni_ring_size(size)	*(volatile unsigned int*)(DMNI_RING_SIZE)=(size)
+#define HAL_set_dmni_ring_head(head)	*(volatile unsigned int*)(DMNI_RING_HEAD)=(head)
+#define HAL_set_dmni_ring_ack(ack)		*(volatile unsigned int*)(DMNI_RING_ACK)=(ack)
+#define HAL_set_dmni_recv_coalesce(c)	*(volatile unsigned int*)(DMNI_RECV_COALESCE)=(c)
+#define HAL_set_dmni_copy_src(addr)		*(volatile unsigned int*)(DMNI_COPY_SRC)=(addr)
+#define HAL_set_dmni_copy_dst(addr)		*(volatile unsigned int*)(DMNI_COPY_DST)=(addr)
+#define HAL_set_dmni_copy_size(size)	*(volatile unsigned int*)(DMNI_COPY_SIZE)=(size)
 #define HAL_set_CS_config(config)		*(volatile unsigned int*)(CONFIG_VALID_NET)=(config)
 #define HAL_set_clock_hold(on_off)		*(volatile unsigned int*)(CLOCK_HOLD)=(on_off)
 #define HAL_set_pending_service(srv)	*(volatile unsigned int*)(PENDING_SERVICE_INTR)=(srv)
 #define HAL_set_CS_request(subnet)		*(volatile unsigned int*)(WRITE_CS_REQUEST)=(subnet)
 #define HAL_set_slack_time_monitor(t)	*(volatile unsigned int*)(SLACK_TIME_MONITOR)=(t)
+#define HAL_set_dvfs_level(level)		*(volatile unsigned int*)(DVFS_LEVEL)=(level)
 #define HAL_set_scheduling_report(code)	*(volatile unsigned int*)(SCHEDULING_REPORT)=(code)
 #define HAL_set_time_slice(t_slice)		*(volatile unsigned int*)(TIME_SLICE)=(t_slice)
 #define HAL_handle_CS_request(req_st)	*(volatile unsigned int*)(HANDLE_CS_REQUEST)=(req_st)
 #define HAL_add_request_debug(v)		*(volatile unsigned int*)(ADD_REQUEST_DEBUG)=(v)
 #define HAL_remv_request_debug(v)		*(volatile unsigned int*)(REM_REQUEST_DEBUG)=(v)
+#define HAL_set_msg_request_task(i, id)	*(volatile unsigned int*)(MSG_REQUEST_TASK)=(((i) << 16) | ((id) & 0xFFFF))
+#define HAL_msg_request_match(key)		*(volatile unsigned int*)(MSG_REQUEST_MATCH)=(key)
+#define HAL_msg_request_match_prod(id)	*(volatile unsigned int*)(MSG_REQUEST_MATCH_PRODUCER)=(id)
+#define HAL_msg_request_match_orphan()	*(volatile unsigned int*)(MSG_REQUEST_MATCH_ORPHAN)=(0)
+#define HAL_set_perf_select(c, index)	*(volatile unsigned int*)(PERF_SELECT)=(((c) << 8) | (index))
 
 /*** Externs of the HAL function implemented in assembly (file HAL_kernel_asm.S) ***/
 extern void HAL_run_scheduled_task(unsigned int);
@@ -145,6 +213,11 @@ unsigned int HAL_interrupt_mask_clear(unsigned int);
 
 unsigned int HAL_interrupt_mask_set(unsigned int);
 
+#if PERF_COUNTERS
+/*Performance counters abstraction*/
+unsigned int HAL_get_perf_counter(unsigned int, unsigned int);
+#endif
+
 /*DMNI Abstraction*/
 inline unsigned int DMNI_read_data_CS(unsigned int, unsigned int);
 
@@ -152,6 +225,20 @@ void DMNI_read_data(unsigned int, unsigned int);
 
 void DMNI_send_data(unsigned int, unsigned int, unsigned int);
 
+#if DMNI_SEND_RING
+unsigned int DMNI_send_ring_done();
+
+unsigned int DMNI_send_ring_free();
+
+void DMNI_send_ring_ack(unsigned int);
+
+unsigned int DMNI_send_ring_push(unsigned int, unsigned int, unsigned int, unsigned int);
+#endif
+
+void DMNI_copy_start(unsigned int, unsigned int, unsigned int);
+
+void DMNI_copy_wait();
+
 void config_subnet(unsigned int, unsigned int, unsigned int);
 
 /*UART abstraction*/
@@ -25,6 +25,12 @@
 #define	REALTIME			6
 #define SENDRAW 			7
 #define IORECEIVE  			8
+//9 to 19 are used by management_api.h
+#define ISENDMESSAGE		20
+#define IRECVMESSAGE		21
+#define WAITREQUEST			22
+#define WAITANYREQUEST		23
+#define TESTREQUEST			24
 
 #define TRUE	1
 #define FALSE	0
@@ -38,6 +44,15 @@ extern int SystemCall();
 #define GetMyID() SystemCall(GETMYID,0,0,0)
 #define Echo(str) SystemCall(ECHO, (char*)str,0,0)
 #define exit() while(!SystemCall(EXIT, 0, 0, 0))
+
+//Non-blocking API - ISend and IRecv store a handle (int) used by Wait, WaitAny and Test. The message buffer
+//cannot be changed (ISend) or read (IRecv) before the handle completes. A task keeps at most one IRecv
+//for each producer, and the handles not waited are limited to 2 per task of the application
+#define ISend(msg, target, handle) while(!(*(handle) = SystemCall(ISENDMESSAGE, (unsigned int*)msg, target, 0)))
+#define IRecv(msg, source, handle) while(!(*(handle) = SystemCall(IRECVMESSAGE, (unsigned int*)msg, source, 0)))
+#define Wait(handle) while(!SystemCall(WAITREQUEST, handle, 0, 0))
+#define WaitAny(handle) while(!SystemCall(WAITANYREQUEST, (unsigned int*)handle, 0, 0))
+#define Test(handle) SystemCall(TESTREQUEST, handle, 0, 0)
 //#define exit(perc) while(!SystemCall(EXIT, perc, 0, 0))/***apagar perc trecho de end simulation****/
 
 //Real-Time API - time represented in microseconds
@@ -0,0 +1,214 @@
+/*!\file collectives.h
+ * MEMPHIS - collective communication for user's tasks
+ *
+ * \brief
+ * Implements Bcast, Scatter, Gather, Reduce and Barrier over a group of tasks of the same application.
+ *
+ * \detailed
+ * The collectives use binomial trees built from the point-to-point API (Send, Receive, ISend and Wait),
+ * so a task forwards data to at most log2(size) tasks and the root is not the single sender anymore.
+ * The PS NoC has no multicast, the tree is the broadcast.
+ * A group is an array with the task names (id_tasks.h) and all tasks of the group call the same collectives
+ * in the same order. The root is an index into the group. The data of Scatter and Gather is ordered by the
+ * group index and size*count must fit into a Message (MSG_SIZE).
+ */
+
+#ifndef __COLLECTIVES_H__
+#define __COLLECTIVES_H__
+
+#include "api.h"
+
+#define COLLECTIVE_MAX_CHILDREN		16		//!< Children of a task into the binomial tree, groups up to 2^16 tasks
+
+/*Reduce operation, acc[i] = acc[i] op in[i]. It must be associative and commutative*/
+typedef void (*ReduceOp)(int * acc, int * in, int length);
+
+Message collective_msg;		//!< Scratch message used to receive the data of the children
+
+/*Returns the index of the task into the group, -1 when the task is not a member*/
+int collective_rank(int * group, int size)
+{
+	int id = GetMyID() & 0xFF;
+
+	for(int i=0; i<size; i++)
+		if (group[i] == id)
+			return i;
+
+	return -1;
+}
+
+/*Returns the lowest power of 2 of the relative rank (its parent distance), or the tree height for the root*/
+int collective_mask(int relative, int size)
+{
+	int mask = 1;
+
+	if (relative == 0){
+		while (mask < size)
+			mask <<= 1;
+	} else {
+		while (!(relative & mask))
+			mask <<= 1;
+	}
+
+	return mask;
+}
+
+/*Rotates data to the left by shift words, in place*/
+void collective_rotate(int * data, int length, int shift)
+{
+	int aux, i, j;
+
+	if (length == 0 || (shift %= length) == 0)
+		return;
+
+	for(i=0, j=shift-1; i<j; i++, j--){
+		aux = data[i]; data[i] = data[j]; data[j] = aux;
+	}
+	for(i=shift, j=length-1; i<j; i++, j--){
+		aux = data[i]; data[i] = data[j]; data[j] = aux;
+	}
+	for(i=0, j=length-1; i<j; i++, j--){
+		aux = data[i]; data[i] = data[j]; data[j] = aux;
+	}
+}
+
+/*The root sends msg to all tasks of the group, the children of each task are sent in parallel by ISend*/
+void Bcast(Message * msg, int root, int * group, int size)
+{
+	int relative = (collective_rank(group, size) - root + size) % size;
+	int mask = collective_mask(relative, size);
+	int handle[COLLECTIVE_MAX_CHILDREN];
+	int children = 0;
+
+	if (relative != 0)
+		Receive(msg, group[(relative - mask + root) % size]);
+
+	//ISend retries while the DMNI is busy, its arguments are evaluated at each retry
+	for(int m = mask >> 1; m > 0; m >>= 1){
+		if (relative + m < size){
+			ISend(msg, group[(relative + m + root) % size], &handle[children]);
+			children++;
+		}
+	}
+
+	for(int i=0; i<children; i++)
+		Wait(handle[i]);
+}
+
+/*The root sends count words of msg to each task of the group, the block i goes to group[i].
+ *At the end msg of each task has its block with length count*/
+void Scatter(Message * msg, int count, int root, int * group, int size)
+{
+	int relative = (collective_rank(group, size) - root + size) % size;
+	int mask = collective_mask(relative, size);
+	int blocks;
+
+	if (relative == 0)
+		//Blocks in the tree order, the root block first
+		collective_rotate(msg->msg, size * count, root * count);
+	else
+		Receive(msg, group[(relative - mask + root) % size]);
+
+	//Each child receives the blocks of its subtree
+	for(int m = mask >> 1; m > 0; m >>= 1){
+		if (relative + m < size){
+
+			blocks = (size - relative - m < m) ? size - relative - m : m;
+
+			collective_msg.length = blocks * count;
+			for(int i=0; i<collective_msg.length; i++)
+				collective_msg.msg[i] = msg->msg[m * count + i];
+
+			Send(&collective_msg, group[(relative + m + root) % size]);
+		}
+	}
+
+	msg->length = count;
+}
+
+/*Each task sends the first count words of msg to the root, which receives size*count words into msg
+ *ordered by the group index. The msg of the other tasks is used as buffer of their subtree*/
+void Gather(Message * msg, int count, int root, int * group, int size)
+{
+	int relative = (collective_rank(group, size) - root + size) % size;
+	int mask = collective_mask(relative, size);
+
+	for(int m = 1; m < mask; m <<= 1){
+		if (relative + m < size){
+
+			Receive(&collective_msg, group[(relative + m + root) % size]);
+
+			for(int i=0; i<collective_msg.length; i++)
+				msg->msg[m * count + i] = collective_msg.msg[i];
+		}
+	}
+
+	msg->length = ((size - relative < mask) ? size - relative : mask) * count;
+
+	if (relative != 0)
+		Send(msg, group[(relative - mask + root) % size]);
+	else
+		//Back to the group order
+		collective_rotate(msg->msg, size * count, (size - root) * count);
+}
+
+/*Combines msg of all tasks with op, the root receives the result into msg.
+ *The msg of the other tasks is used as accumulator of their subtree*/
+void Reduce(Message * msg, ReduceOp op, int root, int * group, int size)
+{
+	int relative = (collective_rank(group, size) - root + size) % size;
+	int mask = collective_mask(relative, size);
+
+	for(int m = 1; m < mask; m <<= 1){
+		if (relative + m < size){
+
+			Receive(&collective_msg, group[(relative + m + root) % size]);
+
+			op(msg->msg, collective_msg.msg, msg->length);
+		}
+	}
+
+	if (relative != 0)
+		Send(msg, group[(relative - mask + root) % size]);
+}
+
+/*Returns when all tasks of the group called Barrier, a token goes up to group[0] and back*/
+void Barrier(int * group, int size)
+{
+	int relative = collective_rank(group, size);
+	int mask = collective_mask(relative, size);
+
+	for(int m = 1; m < mask; m <<= 1)
+		if (relative + m < size)
+			Receive(&collective_msg, group[relative + m]);
+
+	collective_msg.length = 1;
+	collective_msg.msg[0] = 0;
+
+	if (relative != 0)
+		Send(&collective_msg, group[relative - mask]);
+
+	Bcast(&collective_msg, 0, group, size);
+}
+
+void ReduceSum(int * acc, int * in, int length)
+{
+	for(int i=0; i<length; i++)
+		acc[i] += in[i];
+}
+
+void ReduceMax(int * acc, int * in, int length)
+{
+	for(int i=0; i<length; i++)
+		if (in[i] > acc[i])
+			acc[i] = in[i];
+}
+
+void ReduceMin(int * acc, int * in, int length)
+{
+	for(int i=0; i<length; i++)
+		if (in[i] < acc[i])
+			acc[i] = in[i];
+}
+
+#endif /*__COLLECTIVES_H__*/
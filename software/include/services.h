@@ -16,8 +16,11 @@
 
 #define 	MESSAGE_REQUEST					0x00000010 //Inter-task communication:	Message sent from the consumer task to the producer task requesting a message
 #define 	MESSAGE_DELIVERY				0x00000020 //Inter-task communication: 	Message sent from the producer task to the consumer task delivering the requested message
+#define 	MESSAGE_CREDIT					0x00000030 //Inter-task communication:	Message sent from the consumer PE to the producer PE granting or returning eager message credits (see EAGER_MESSAGING)
+#define 	MESSAGE_CREDIT_REVOKE			0x00000035 //Inter-task communication:	Message sent from the producer PE to the consumer PE giving back its credits, the next message is larger than an eager buffer and needs a MESSAGE_REQUEST
 #define 	TASK_ALLOCATION     			0x00000040 //Mapping: 				   	Message sent from the AppInjector to a given slave PE containing the task obj code
 #define 	TASK_ALLOCATED     				0x00000050 //Mapping: 				   	Message sent from a slave PE to the LM (Local Mapper), reporting the it receives the TASK_ALLOCATION message and the task was loaded into the memory
+#define 	CODE_CACHE_MISS					0x00000055 //Mapping: 				   	Message sent from a slave PE to the LM when the cached task code referenced by a TASK_ALLOCATION is no longer into its memory
 #define 	TASK_TERMINATED     			0x00000070 //Mapping: 				   	Message sent from a slave PE to the LM when a user's task finishes it execution
 #define 	LOAN_PROCESSOR_RELEASE			0x00000090 //Mapping (Reclustering): 	Message sent from an LM to other LM releasing a borrowed resource (a resource is a memory page in Memphis)
 #define 	APP_ALLOCATED					0x00000120 //Mapping:					Message sent from an LM to GM (Global Mapper) informing that the application was successfully mapped and loaded into the slave PEs
@@ -41,6 +44,7 @@
 #define 	SLACK_TIME_REPORT				0x00000260 //Monitoring:				Message sent from a slave PE to LM updating the percentage of idle time of the CPU
 #define 	DEADLINE_MISS_REPORT			0x00000270 //Monitoring:				Message sent from a slave PE to LM notifying a deadline miss from a given real-time task
 #define 	LATENCY_MISS_REPORT				0x00000275 //Monitoring:				Message sent from a slave PE to LM notifying a latency miss from a given real-time task
+#define 	PERF_COUNTERS_REPORT			0x00000278 //Monitoring:				Message sent from a slave PE to LM with the PE slack time measured by the performance counters
 #define 	RT_CONSTRANTS					0x00000280 //Real-Time Scheduler:		Message sent from a slave PE to LM informing that a given real-time task update its constraints
 #define 	RT_CONSTRANTS_OTHER_CLUSTER		0x00000285 //Real-Time Scheduler:		Message sent from a slave PE (from other cluster) to LM informing that a given real-time task update its constraints
 #define		NEW_APP_REQ						0x00000290 //Mapping:					Message sent from AppInjector to GM informing that a new application is requesting to execute
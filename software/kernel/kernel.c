@@ -28,6 +28,9 @@
 #include "modules/enforcer_mapping.h"
 #include "modules/enforcer_sdn.h"
 #include "modules/monitor.h"
+#if DVFS
+#include "modules/enforcer_dvfs.h"
+#endif
 #if MIGRATION_ENABLED
 #include "modules/enforcer_migration.h"
 #endif
@@ -59,10 +62,24 @@ int OS_syscall_handler(unsigned int service, unsigned int arg0, unsigned int arg
 			HAL_enable_scheduler_after_syscall();
 
 			//Deadlock avoidance: avoids to send a packet when the DMNI is busy in send process
-			if (HAL_is_send_active(PS_SUBNET)){
+			if (is_send_active(PS_SUBNET)){
+				return 0;
+			}
+
+#if OUTBOX_DEPTH
+			//The task terminates after its buffered messages are requested
+			if (outbox_count(current)){
+				return 0;
+			}
+#endif
+
+			//The ISends and IRecvs not waited must complete before
+			if (async_request_count(current)){
 				return 0;
 			}
 
+			clear_async_requests(current);
+
 			puts("Task id: "); puts(itoa(current->id)); putsv(" terminated at ", HAL_get_tick());
 
 			//send_task_terminated(current, arg0);
@@ -70,6 +87,10 @@ int OS_syscall_handler(unsigned int service, unsigned int arg0, unsigned int arg
 
 			clear_scheduling(current->scheduling_ptr);
 
+#if EAGER_MESSAGING
+			clear_eager_messaging(current->id);
+#endif
+
 			appID = current->id >> 8;
 
 			if ( !is_another_task_running(appID) ){
@@ -85,7 +106,27 @@ int OS_syscall_handler(unsigned int service, unsigned int arg0, unsigned int arg
 
 		case RECVMESSAGE:
 
-			return receive_message(current, arg0, arg1);
+			return receive_message(current, arg0, arg1, 0);
+
+		case ISENDMESSAGE:
+
+			return isend_message(current, arg0, arg1);
+
+		case IRECVMESSAGE:
+
+			return irecv_message(current, arg0, arg1);
+
+		case WAITREQUEST:
+
+			return wait_request(current, arg0);
+
+		case WAITANYREQUEST:
+
+			return wait_any_request(current, arg0);
+
+		case TESTREQUEST:
+
+			return test_request(current, arg0);
 
 		case GETTICK:
 
@@ -111,7 +152,7 @@ int OS_syscall_handler(unsigned int service, unsigned int arg0, unsigned int arg
 
 		case REALTIME:
 
-			if (HAL_is_send_active(PS_SUBNET)){
+			if (is_send_active(PS_SUBNET)){
 				return 0;
 			}
 
@@ -129,7 +170,7 @@ int OS_syscall_handler(unsigned int service, unsigned int arg0, unsigned int arg
 
 			HAL_enable_scheduler_after_syscall();
 
-			if(HAL_is_send_active(PS_SUBNET)){
+			if(is_send_active(PS_SUBNET)){
 				puts("Preso no SENDRAW\n");
 				return 0;
 			}
@@ -137,6 +178,10 @@ int OS_syscall_handler(unsigned int service, unsigned int arg0, unsigned int arg
 
 			msg_address_src = (unsigned int *) (current->offset | arg0);
 
+			//Raw packets of the management tasks: header, payload size and service in the first flits
+			if (is_management_service(msg_address_src[2]))
+				msg_address_src[0] |= PRIORITY_PKT;
+
 			DMNI_send_data((unsigned int)msg_address_src, arg1, PS_SUBNET);
 
 			return 1;
@@ -145,6 +190,7 @@ int OS_syscall_handler(unsigned int service, unsigned int arg0, unsigned int arg
 		case REQSERVICEMODE:
 			//TODO: a protocol that only grants a service permission to secure tasks
 			current->is_service_task = 1;
+			update_ready_bitmaps(current->scheduling_ptr);
 
 			HAL_interrupt_mask_clear(0xffffffff);
 
@@ -160,7 +206,7 @@ int OS_syscall_handler(unsigned int service, unsigned int arg0, unsigned int arg
 			receive_MA(current, arg0);
 
 			//Allows interruptions
-			HAL_interrupt_mask_set(interrput_mask);
+			HAL_interrupt_mask_set(send_queue_mask(pending_service_mask(interrput_mask)));
 
 			return 0;
 
@@ -174,7 +220,7 @@ int OS_syscall_handler(unsigned int service, unsigned int arg0, unsigned int arg
 /*Here starts the support for the management task API used for MA task*/
 		case CFGROUTER:
 
-			if (HAL_is_send_active(PS_SUBNET))
+			if (is_send_active(PS_SUBNET))
 				return 0;
 
 			send_config_router(arg0, arg1 >> 8, arg1 & 0xFF, arg2);
@@ -182,14 +228,14 @@ int OS_syscall_handler(unsigned int service, unsigned int arg0, unsigned int arg
 			return 1;
 		case NOCSENDFREE:
 			//If DMNI send is active them return FALSE
-			if (HAL_is_send_active(PS_SUBNET))
+			if (is_send_active(PS_SUBNET))
 				return 0;
 			//Otherwise return TRUE
 			return 1;
 
 		case INCOMINGPACKET:
 
-			return (HAL_get_irq_status() >= IRQ_INIT_NOC);
+			return ((HAL_get_irq_status() & IRQ_NOC) != 0);
 
 		case GETNETADDRESS:
 
@@ -246,6 +292,20 @@ int handle_packet(volatile ServiceHeader * p, unsigned int subnet) {
 
 		break;
 
+#if EAGER_MESSAGING
+	case MESSAGE_CREDIT:
+
+		handle_message_credit(p);
+
+		break;
+
+	case MESSAGE_CREDIT_REVOKE:
+
+		handle_message_credit_revoke(p);
+
+		break;
+#endif
+
 	case TASK_ALLOCATION:
 
 		handle_task_allocation(p);
@@ -309,6 +369,7 @@ int handle_packet(volatile ServiceHeader * p, unsigned int subnet) {
  *These services could be visible only at MA task scope, however, they still here to allow the debugging to work properly*/
 	case TASK_TERMINATED:
 	case TASK_ALLOCATED:
+	case CODE_CACHE_MISS:
 	case APP_TERMINATED:
 	case TASK_TERMINATED_OTHER_CLUSTER:
 	case APP_ALLOCATED:
@@ -338,6 +399,7 @@ int handle_packet(volatile ServiceHeader * p, unsigned int subnet) {
 	case NI_STATUS_RESPONSE:
 	case NOC_SWITCHING_CTP_CONCLUDED:
 	case LATENCY_MISS_REPORT:
+	case PERF_COUNTERS_REPORT:
 	//case LM_FAULT_REPORT:
 	case SDN_FAULT_REPORT:
 
@@ -452,20 +514,35 @@ void OS_interruption_handler(unsigned int status) {
 
 	call_scheduler = 0;
 
-	if ( status >= IRQ_INIT_NOC ){ //If the interruption comes from the MPN NoC
+#if DMNI_SEND_RING
+	//Send ring completion, only enabled while the send queue holds packets
+	if ( status & IRQ_DMNI_RING ){
+		send_queue_drain();
+	}
+#endif
+
+	if ( status & IRQ_NOC ){ //If the interruption comes from the MPN NoC
 
 		if (status & IRQ_PS){//If the interruption comes from the PS subnet
 
+#if DMNI_RECV_COALESCING
+			//Drains all the packets stored into the DMNI receive FIFO in a single kernel entry
+			do {
+#endif
 			read_packet((ServiceHeader *)&p);
 
-			if (HAL_is_send_active(PS_SUBNET) && (p.service == MESSAGE_REQUEST || p.service == TASK_MIGRATION) ){
+			if (is_send_active(PS_SUBNET) && (p.service == MESSAGE_REQUEST || p.service == MESSAGE_CREDIT_REVOKE || p.service == TASK_MIGRATION) ){
 
 				add_pending_service((ServiceHeader *)&p);
 
 			} else {
 
-				call_scheduler = handle_packet(&p, PS_SUBNET);
+				call_scheduler |= handle_packet(&p, PS_SUBNET);
 			}
+#if DMNI_RECV_COALESCING
+			//Stops when the pending service FIFO applies backpressure, the IRQ_PS is masked
+			} while (HAL_get_dmni_recv_pending() && (HAL_get_irq_mask() & IRQ_PS));
+#endif
 
 		} else { //If the interruption comes from the CS subnet
 
@@ -475,7 +552,10 @@ void OS_interruption_handler(unsigned int status) {
 
 					p.service = MESSAGE_DELIVERY;
 
-					p.consumer_task = get_ctp_ptr(subnet, DMNI_RECEIVE_OP)->consumer_task;
+					ctp_ptr = get_ctp_ptr(subnet, DMNI_RECEIVE_OP);
+
+					p.producer_task = ctp_ptr->producer_task;
+					p.consumer_task = ctp_ptr->consumer_task;
 
 					call_scheduler = handle_packet(&p, subnet);
 
@@ -517,8 +597,31 @@ void OS_interruption_handler(unsigned int status) {
 		}
 
 
+#if MSG_REQUEST_TABLE
+	} else if (status & IRQ_MSG_REQUEST){ //Request absorbed by the hardware table to a producer not located here
+
+		HAL_msg_request_match_orphan();
+
+		p.service = MESSAGE_REQUEST;
+		p.producer_task = HAL_get_msg_request_tasks() >> 16;
+		p.consumer_task = HAL_get_msg_request_tasks() & 0xFFFF;
+		p.requesting_processor = HAL_get_msg_request_result();
+
+		if (is_send_active(PS_SUBNET)){
+			add_pending_service((ServiceHeader *)&p);
+		} else {
+			call_scheduler = handle_packet(&p, PS_SUBNET);
+		}
+
+#endif
 	} else if (status & IRQ_SLACK_TIME){
+#if DVFS
+		dvfs_update(get_slack_time());
+#endif
 		send_slack_time_report();
+#if PERF_COUNTERS
+		send_perf_counters_report();
+#endif
 		HAL_set_slack_time_monitor(SLACK_TIME_WINDOW);
 	}
 
@@ -602,6 +705,9 @@ int main(){
 
 	/*enables timeslice counter and wrapper interrupts*/
 	interrput_mask = IRQ_SCHEDULER | IRQ_PENDING_SERVICE | IRQ_SLACK_TIME | IRQ_CS_REQUEST | interrput_mask;
+#if MSG_REQUEST_TABLE
+	interrput_mask |= IRQ_MSG_REQUEST;
+#endif
 	//OS_InterruptMaskSet(IRQ_SCHEDULER | IRQ_PENDING_SERVICE | IRQ_SLACK_TIME | IRQ_CS_REQUEST | interrput_mask);
 	//Slack-time disabled
 	HAL_interrupt_mask_set(interrput_mask);
@@ -79,6 +79,8 @@ void init_TCBs(){
 		tcbs[i].add_ctp = 0;
 		tcbs[i].is_service_task = 0;
 		tcbs[i].recv_buffer = 0;
+		tcbs[i].recv_source = -1;
+		tcbs[i].code_hash = 0;
 
 		//Inicializes learning profile
 		tcbs[i].communication_time = 0;
@@ -98,11 +100,18 @@ void init_TCBs(){
 	}
 }
 
-/**Search from a tcb position with status equal to FREE
+/**Search from a tcb position with status equal to FREE. The pages without a cached task code are
+ * used first, keeping the code of the terminated tasks for a further TASK_ALLOCATION
  * \return The TCB pointer or 0 in a ERROR situation
  */
 TCB* search_free_TCB() {
 
+    for(int i=0; i<MAX_LOCAL_TASKS; i++){
+		if(tcbs[i].scheduling_ptr->status == FREE && tcbs[i].code_hash == 0){
+			return &tcbs[i];
+		}
+	}
+
     for(int i=0; i<MAX_LOCAL_TASKS; i++){
 		if(tcbs[i].scheduling_ptr->status == FREE){
 			return &tcbs[i];
@@ -114,6 +123,21 @@ TCB* search_free_TCB() {
     return 0;
 }
 
+/**Search for a FREE tcb which page keeps the TEXT section of a terminated task
+ * \param code_hash Hash of the wanted TEXT section
+ * \return The TCB pointer or 0 when the code is not cached
+ */
+TCB * search_cached_TCB(unsigned int code_hash){
+
+	for(int i=0; i<MAX_LOCAL_TASKS; i++){
+		if(tcbs[i].scheduling_ptr->status == FREE && code_hash != 0 && tcbs[i].code_hash == code_hash){
+			return &tcbs[i];
+		}
+	}
+
+	return 0;
+}
+
 /**Search by a TCB
  * \param task_id Task ID to be searched
  * \return TCB pointer
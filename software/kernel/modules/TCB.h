@@ -29,6 +29,7 @@ typedef struct {
     unsigned int offset;        	//!<initial address of the task code in page
     int       	 id;            	//!<identifier
     unsigned int recv_buffer;		//!<Buffer pointer of requested message
+    int			 recv_source;		//!<Producer task of the pending Receive, used to match the eager messages
 
 	unsigned int text_lenght;   	//!<Memory TEXT section lenght in bytes
     unsigned int data_lenght;		//!<Memory DATA section lenght in bytes
@@ -38,6 +39,7 @@ typedef struct {
     unsigned int remove_ctp;		//!<Flag (1|0) to remove a given CTP
     unsigned int add_ctp;			//!<Flag (1|0) to add a given CTP
     unsigned int is_service_task;	//!<If 0 means a user tasks, otherwise means a service task
+    unsigned int code_hash;			//!<Hash of the TEXT section kept into the page, still valid after the task terminates (task code cache). 0 when unknown
 
     //Learning informations
     unsigned int communication_time;//!<Stores the total time spend in communication
@@ -62,6 +64,8 @@ void send_learned_profile(unsigned int);
 
 TCB * search_free_TCB();
 
+TCB * search_cached_TCB(unsigned int);
+
 TCB * searchTCB(unsigned int);
 
 int is_another_task_running(int);
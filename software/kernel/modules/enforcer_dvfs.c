@@ -3,8 +3,64 @@
  *
  *  Created on: Sep 19, 2019
  *      Author: ruaro
+ *
+ *  Description: Selects the CPU clock level of the PE. Level L enables the CPU clock once every 2^L cycles
+ *  (see DVFS_LEVEL into the SystemC pe), the NoC, DMNI and memory keep the full clock.
+ */
+
+#include "enforcer_dvfs.h"
+
+#include "../../hal/mips/HAL_kernel.h"
+#include "task_scheduler.h"
+#include "TCB.h"
+#include "utils.h"
+
+unsigned int dvfs_level = 0;	//!< Current CPU clock level, 0 is the full clock
+
+/** Gets the current DVFS level
+ * \return The CPU clock level, the CPU runs at 1/2^level of the PE clock
+ */
+unsigned int get_dvfs_level(){
+	return dvfs_level;
+}
+
+/** Selects the slowest level that keeps the CPU load and the RT utilization under DVFS_TARGET_LOAD.
+ * Called every SLACK_TIME_WINDOW. The clock is slowed down one level per window and speeded up at once,
+ * and PEs running management tasks always keep the full clock
+ * \param slack_time Slack time (%) measured in the last window at the current level
  */
+void dvfs_update(unsigned int slack_time){
+
+	unsigned int load, rt_load, new_level;
+	TCB * tcb_ptr;
+
+	//Load the CPU would have at the full clock
+	load = (100 - slack_time) >> dvfs_level;
+
+	rt_load = get_cpu_utilization();
+
+	new_level = 0;
+
+	while (new_level < DVFS_LEVELS-1 && (load << (new_level+1)) <= DVFS_TARGET_LOAD && (rt_load << (new_level+1)) <= DVFS_TARGET_LOAD)
+		new_level++;
+
+	if (new_level > dvfs_level + 1)
+		new_level = dvfs_level + 1;
+
+	for(int i=0; i<MAX_LOCAL_TASKS; i++){
+		tcb_ptr = get_tcb_index_ptr(i);
+		if (tcb_ptr->scheduling_ptr->status != FREE && tcb_ptr->is_service_task){
+			new_level = 0;
+			break;
+		}
+	}
 
+	if (new_level != dvfs_level){
 
+		dvfs_level = new_level;
 
+		HAL_set_dvfs_level(dvfs_level);
 
+		//puts("DVFS level "); puts(itoa(dvfs_level)); putsv(", slack ", slack_time);
+	}
+}
@@ -8,8 +8,12 @@
 #ifndef SOFTWARE_KERNEL_MODULES_ENFORCER_DVFS_H_
 #define SOFTWARE_KERNEL_MODULES_ENFORCER_DVFS_H_
 
+#include "../../../include/kernel_pkg.h"
 
+#define DVFS_TARGET_LOAD	80		//!<Maximum CPU load (%) expected after slowing down the CPU clock
 
+void dvfs_update(unsigned int);
 
+unsigned int get_dvfs_level();
 
 #endif /* SOFTWARE_KERNEL_MODULES_ENFORCER_DVFS_H_ */
@@ -19,7 +19,66 @@
 #include "task_communication.h"
 #include "utils.h"
 
-TaskLocation task_location[MAX_TASK_LOCATION];	//!<array of TaskLocation
+TaskLocation task_location[MAX_TASK_LOCATION];	//!<array of TaskLocation, open addressing table indexed by task_location_hash
+
+/**Home position of a task into task_location. The tasks of an application are consecutive, so without
+ * collisions between applications the table is direct-indexed by (app_id, task_id)
+ * \param task_ID The ID of the task
+ * \return Index into task_location
+ */
+static inline int task_location_hash(int task_ID){
+	return ((task_ID >> 8) * MAX_TASKS_APP + (task_ID & 0xFF)) % MAX_TASK_LOCATION;
+}
+
+/**Searches the position of a task into task_location by linear probing
+ * \param task_ID The ID of the task
+ * \return Index of the task, or the free position ending the probe (-1 if the table is full)
+ */
+static int task_location_index(int task_ID){
+
+	int i = task_location_hash(task_ID);
+
+	for(int probe=0; probe<MAX_TASK_LOCATION; probe++){
+
+		if (task_location[i].id == task_ID || task_location[i].id == -1)
+			return i;
+
+		if (++i == MAX_TASK_LOCATION)
+			i = 0;
+	}
+
+	return -1;
+}
+
+/**Removes the entry of a position, moving back the next entries of the probe sequence (no tombstones)
+ * \param hole Index of the entry to be removed
+ */
+static void task_location_delete(int hole){
+
+	int i = hole;
+	int home;
+
+	for(;;){
+
+		if (++i == MAX_TASK_LOCATION)
+			i = 0;
+
+		if (task_location[i].id == -1 || i == hole)
+			break;
+
+		home = task_location_hash(task_location[i].id);
+
+		//The entry stays when its home is cyclically into (hole, i]
+		if ( (hole < i) ? (home > hole && home <= i) : (home > hole || home <= i) )
+			continue;
+
+		task_location[hole] = task_location[i];
+		hole = i;
+	}
+
+	task_location[hole].id = -1;
+	task_location[hole].proc_address = -1;
+}
 
 /**Initializes task_location array with invalid values
  */
@@ -36,40 +95,30 @@ void init_task_location(){
  */
 int get_task_location(int task_ID){
 
-	for(int i=0; i<MAX_TASK_LOCATION; i++) {
-		if (task_location[i].id == task_ID){
-			return task_location[i].proc_address;
-		}
-	}
-	return -1;
+	int i = task_location_index(task_ID);
+
+	if (i == -1 || task_location[i].id != task_ID)
+		return -1;
+
+	return task_location[i].proc_address;
 }
 
-/**Add a task_locaiton instance
+/**Add a task_locaiton instance, an older location of the task is replaced
  * \param task_ID Task ID
  * \param proc Location (address) of the task
  */
 void add_task_location(int task_ID, int proc){
 
-	//Ensure to remove all older instances of locations for this task_id
-	for(int i=0; i<MAX_TASK_LOCATION; i++) {
-		if (task_location[i].id == task_ID){
-			task_location[i].id = -1;
-			task_location[i].proc_address = -1;
-		}
-	}
+	int i = task_location_index(task_ID);
 
-	//Insert the task location in the first free position
-	for(int i=0; i<MAX_TASK_LOCATION; i++) {
-		if (task_location[i].id == -1){
-			task_location[i].id = task_ID;
-			task_location[i].proc_address = proc;
-			puts("Add task location - task id "); puts(itoa(task_ID)); puts(" proc "); puts(itoh(proc)); puts("\n");
-			return;
-		}
+	if (i == -1){
+		puts("ERROR - no FREE Task location\n");
+		while(1);
 	}
 
-	puts("ERROR - no FREE Task location\n");
-	while(1);
+	task_location[i].id = task_ID;
+	task_location[i].proc_address = proc;
+	puts("Add task location - task id "); puts(itoa(task_ID)); puts(" proc "); puts(itoh(proc)); puts("\n");
 }
 
 /**Remove a task_locaton instance
@@ -79,19 +128,15 @@ void add_task_location(int task_ID, int proc){
 int remove_task_location(int task_id){
 
 	int r_proc;
+	int i = task_location_index(task_id);
 
-	for(int i=0; i<MAX_TASK_LOCATION; i++) {
-
-		if (task_location[i].id == task_id){
-
-			task_location[i].id = -1;
+	if (i != -1 && task_location[i].id == task_id){
 
-			r_proc = task_location[i].proc_address;
+		r_proc = task_location[i].proc_address;
 
-			task_location[i].proc_address = -1;
-			//puts("Add task location - task id "); puts(itoa(task_ID)); puts(" proc "); puts(itoh(proc)); puts("\n");
-			return r_proc;
-		}
+		task_location_delete(i);
+		//puts("Add task location - task id "); puts(itoa(task_ID)); puts(" proc "); puts(itoh(proc)); puts("\n");
+		return r_proc;
 	}
 
 	puts("ERROR - task not found to remove\n");
@@ -105,10 +150,10 @@ int remove_task_location(int task_id){
 void clear_app_tasks_locations(int app_ID){
 
 	for(int i=0;i<MAX_TASK_LOCATION; i++){
-		if (task_location[i].id != -1 && (task_location[i].id >> 8) == app_ID){
+		//The deletion moves the next entries back, so the position is checked again
+		while (task_location[i].id != -1 && (task_location[i].id >> 8) == app_ID){
 			//puts("Remove task location - task id "); puts(itoa(task_location[i].id)); puts(" proc "); puts(itoh(task_location[i].proc_address)); puts("\n");
-			task_location[i].id = -1;
-			task_location[i].proc_address = -1;
+			task_location_delete(i);
 		}
 	}
 }
@@ -179,6 +224,7 @@ void set_task_release(unsigned int source_addr, char from_noc){
 
 	if (tcb_ptr->scheduling_ptr->status == BLOCKED){
 		tcb_ptr->scheduling_ptr->status = READY;
+		update_ready_bitmaps(tcb_ptr->scheduling_ptr);
 	}
 
 	for (int i = 0; i < app_task_number; i++){
@@ -213,7 +259,7 @@ void send_task_allocated(TCB * allocated_task){
 
 		send_service_to_MA(master_task_id, master_addr, message, 2);
 
-		while(HAL_is_send_active(PS_SUBNET));
+		while(is_send_active(PS_SUBNET));
 
 		//puts("Sending task allocated\n");
 	}
@@ -227,12 +273,13 @@ void send_task_allocated(TCB * allocated_task){
 //void send_task_terminated(TCB * terminated_task, int perc){/*<--- perc**apagar trecho de end simulation****/
 void send_task_terminated(TCB * terminated_task){
 
-	unsigned int message[3];
+	unsigned int message[4];
 	unsigned int master_addr, master_id;
 
 	message[0] = TASK_TERMINATED;
 	message[1] = terminated_task->id; //p->task_ID
 	message[2] = terminated_task->master_address;
+	message[3] = terminated_task->code_hash; //The page keeps the task code, see search_cached_TCB
 
 	master_addr = terminated_task->master_address & 0xFFFF;
 	master_id = terminated_task->master_address >> 16;
@@ -243,31 +290,141 @@ void send_task_terminated(TCB * terminated_task){
 
 		//puts("Escrita local: send_task_terminated\n");
 
-		write_local_service_to_MA(master_id, message, 3);
+		write_local_service_to_MA(master_id, message, 4);
 
 	} else {
 
-		send_service_to_MA(master_id, master_addr, message, 3);
+		send_service_to_MA(master_id, master_addr, message, 4);
 
 		//putsv("Master id: ", master_id);
 
-		while(HAL_is_send_active(PS_SUBNET));
+		while(is_send_active(PS_SUBNET));
 	}
 
 }
 
+/**Returns a byte of the compressed task code stream, bytes are packed from the most significant byte of each word
+ * \param src Address of the token stream
+ * \param index Byte index
+ */
+static inline unsigned int code_stream_byte(unsigned int * src, unsigned int index){
+	return (src[index >> 2] >> (24 - ((index & 3) << 3))) & 0xFF;
+}
+
+/**Decodes the compressed task code generated by app_builder.py (see compress_task_code). The stream is received at the
+ * end of the task page and decoded in place to the page begin, app_builder.py ensures that the decoded words never reach
+ * the stream bytes not consumed yet
+ * \param dst Task page address
+ * \param src Address of the compressed stream
+ * \param code_lenght Size in words of the decoded code
+ */
+static void decompress_task_code(unsigned int * dst, unsigned int * src, unsigned int code_lenght){
+
+	unsigned int * dictionary;
+	unsigned int * copy_ptr;
+	unsigned int byte_index, tag, word, count, out;
+
+	//Word 0 is the size of the token stream, the dictionary is placed after it
+	dictionary = src + 1 + src[0];
+	src++;
+
+	byte_index = 0;
+	out = 0;
+
+	while(out < code_lenght){
+
+		tag = code_stream_byte(src, byte_index++);
+
+		if (tag < 0x80){ //Dictionary word
+
+			dst[out++] = dictionary[tag];
+
+		} else if (tag < 0xC0){ //Literal words
+
+			for(count = (tag & 0x3F) + 1; count > 0; count--){
+				word = code_stream_byte(src, byte_index++) << 24;
+				word |= code_stream_byte(src, byte_index++) << 16;
+				word |= code_stream_byte(src, byte_index++) << 8;
+				word |= code_stream_byte(src, byte_index++);
+				dst[out++] = word;
+			}
+
+		} else { //Copy of decoded words
+
+			count = (tag & 0x3F) + 2;
+			word = code_stream_byte(src, byte_index++) << 8;
+			word |= code_stream_byte(src, byte_index++);
+			copy_ptr = &dst[out - word];
+
+			for(; count > 0; count--)
+				dst[out++] = *(copy_ptr++);
+		}
+	}
+}
+
+/**Handles a TASK_ALLOCATION that references a task code no longer cached into this PE. The DATA section is drained
+ * into a free page, which loses its cached code, and the master is notified to request the whole task code again
+ * \param pkt TASK_ALLOCATION packet
+ */
+void handle_code_cache_miss(volatile ServiceHeader * pkt){
+
+	TCB * tcb_ptr;
+	unsigned int message[3];
+	unsigned int master_addr, master_id;
+
+	tcb_ptr = search_free_TCB();
+	tcb_ptr->code_hash = 0;
+
+	if (pkt->data_size)
+		DMNI_read_data(tcb_ptr->offset, pkt->data_size);
+
+	message[0] = CODE_CACHE_MISS;
+	message[1] = pkt->task_ID;
+	message[2] = net_address;
+
+	master_addr = pkt->master_ID & 0xFFFF;
+	master_id = pkt->master_ID >> 16;
+
+	puts("Code cache miss for task "); puts(itoa(pkt->task_ID)); puts("\n");
+
+	if (master_addr == net_address){
+
+		write_local_service_to_MA(master_id, message, 3);
+
+	} else {
+
+		send_service_to_MA(master_id, master_addr, message, 3);
+
+		while(is_send_active(PS_SUBNET));
+	}
+}
+
 void handle_task_allocation(volatile ServiceHeader * pkt){
 
 	TCB * tcb_ptr;
 	unsigned int code_lenght;
 	volatile unsigned int * bss_ptr;
 
-	tcb_ptr = search_free_TCB();
+	if (pkt->cached_code){
+
+		tcb_ptr = search_cached_TCB(pkt->code_hash);
+
+		if (!tcb_ptr){
+			handle_code_cache_miss(pkt);
+			return;
+		}
+
+	} else
+		tcb_ptr = search_free_TCB();
+
+	tcb_ptr->code_hash = pkt->code_hash;
 
 	tcb_ptr->pc = 0;
 
 	tcb_ptr->id = pkt->task_ID;
 
+	set_local_producer(tcb_ptr, tcb_ptr->id);
+
 	puts("Task id: "); puts(itoa(tcb_ptr->id)); putsv(" allocated at ", HAL_get_tick());
 
 	code_lenght = pkt->code_size;
@@ -293,7 +450,16 @@ void handle_task_allocation(volatile ServiceHeader * pkt){
 
 	tcb_ptr->scheduling_ptr->remaining_exec_time = MAX_TIME_SLICE;
 
-	DMNI_read_data(tcb_ptr->offset, code_lenght);
+	if (pkt->cached_code){
+		//The TEXT section is kept into the page, only the DATA section, placed at its end, is received
+		if (pkt->data_size)
+			DMNI_read_data(tcb_ptr->offset + ((code_lenght - pkt->data_size) * 4), pkt->data_size);
+	} else if (pkt->compressed_code_size){
+		//Receives the compressed code at the end of the page, not used before the task starts its stack
+		DMNI_read_data(tcb_ptr->offset + PAGE_SIZE - (pkt->compressed_code_size * 4), pkt->compressed_code_size);
+		decompress_task_code((unsigned int *) tcb_ptr->offset, (unsigned int *)(tcb_ptr->offset + PAGE_SIZE - (pkt->compressed_code_size * 4)), code_lenght);
+	} else
+		DMNI_read_data(tcb_ptr->offset, code_lenght);
 
 	if ((tcb_ptr->id >> 8) == 0){//Task of APP 0 (mapping) dont need to be released to start its execution
 		tcb_ptr->scheduling_ptr->status = READY;
@@ -302,6 +468,8 @@ void handle_task_allocation(volatile ServiceHeader * pkt){
 		send_task_allocated(tcb_ptr);
 	}
 
+	update_ready_bitmaps(tcb_ptr->scheduling_ptr);
+
 	//Clean the BSS memory region in order to avoid task to use trash from other tasks
 	bss_ptr = (unsigned int *)(tcb_ptr->offset + (code_lenght * 4));
 	for(int i=0; i < (tcb_ptr->bss_lenght+1); i++){
@@ -47,6 +47,8 @@ void send_task_allocated(TCB *);
 
 void send_task_terminated(TCB *);
 
+void handle_code_cache_miss(volatile ServiceHeader *);
+
 void handle_task_allocation(volatile ServiceHeader *);
 
 
@@ -181,7 +181,10 @@ void migrate_dynamic_memory(TCB * tcb_aux){
 #endif
 
 	// ----- task request -----
-	request_array_size = remove_all_requested_msgs(tcb_aux->id, request_msg);
+	//From now on the requests to this task are forwarded to the new processor
+	set_local_producer(tcb_aux, -1);
+
+	request_array_size = remove_all_requested_msgs(tcb_aux, request_msg);
 
 	if (request_array_size > 0){
 
@@ -297,9 +300,12 @@ void migrate_CODE(TCB* tcb_migration){
 void handle_migration_code(volatile ServiceHeader * p, TCB * migrate_tcb){
 
 	migrate_tcb->scheduling_ptr->status = MIGRATING;
+	update_ready_bitmaps(migrate_tcb->scheduling_ptr);
 
 	migrate_tcb->id = p->task_ID;
 
+	set_local_producer(migrate_tcb, migrate_tcb->id);
+
 	migrate_tcb->master_address = p->master_ID;
 
 	migrate_tcb->text_lenght = p->code_size;
@@ -428,7 +434,7 @@ void handle_migration_request_msg(volatile ServiceHeader * p, TCB * migrate_tcb)
 #if TASK_MIGRATION_DEBUG
 			putsvsv("requester: ", requester, " requested: ", requested);
 #endif
-			insert_message_request(requested, requester, requester_proc);
+			insert_message_request(migrate_tcb, requester, requester_proc);
 		}
 	}
 
@@ -471,6 +477,7 @@ void handle_migration_DATA_BSS(volatile ServiceHeader * p, TCB * migrate_tcb){
 	}
 
 	migrate_tcb->scheduling_ptr->status = READY;
+	update_ready_bitmaps(migrate_tcb->scheduling_ptr);
 
 	migrate_tcb->proc_to_migrate = -1;
 
@@ -539,6 +546,7 @@ int handle_migration(volatile ServiceHeader * p){
 
 	if (p->service == MIGRATION_CODE){
 		migrate_tcb = search_free_TCB();
+		migrate_tcb->code_hash = 0; //The page code is replaced by the migrated one
 	} else {
 		migrate_tcb = searchTCB(p->task_ID);
 	}
@@ -20,9 +20,11 @@
 #include "enforcer_mapping.h"
 #include "utils.h"
 
-#define MAX_CTP	(SUBNETS_NUMBER-1) * 2 //!< Maximum number of ctp into a slave processor
+#define MAX_CTP	((SUBNETS_NUMBER-1) * 2) //!< Maximum number of ctp into a slave processor
 
-CTP ctp[ MAX_CTP ];
+#define CTP_INDEX(subnet, dmni_op)	((subnet) * 2 + (dmni_op)) //!< Each CS subnet has one send (0) and one receive (1) ctp
+
+CTP ctp[ MAX_CTP ];				//!< Direct indexed by CTP_INDEX, a ctp is free when subnet is -1
 
 void init_ctp(){
 	for(int i=0; i<MAX_CTP; i++){
@@ -34,10 +36,10 @@ void init_ctp(){
 
 CTP * get_ctp_ptr(int subnet, int dmni_op){
 
-	for(int i=0; i<MAX_CTP; i++){
-		if (ctp[i].subnet == subnet && ctp[i].dmni_op == dmni_op){
-			return &ctp[i];
-		}
+	int i = CTP_INDEX(subnet, dmni_op);
+
+	if (subnet >= 0 && subnet < (SUBNETS_NUMBER-1) && ctp[i].subnet == subnet && ctp[i].dmni_op == dmni_op){
+		return &ctp[i];
 	}
 	puts("ERROR: ctp not found - subnet "); puts(itoa(subnet)); putsv(" dmni op ", dmni_op);
 
@@ -47,7 +49,9 @@ CTP * get_ctp_ptr(int subnet, int dmni_op){
 
 CTP * add_ctp(int producer_task, int consumer_task, int dmni_op, int subnet){
 
-	for(int i=0; i<MAX_CTP; i++){
+	int i = CTP_INDEX(subnet, dmni_op);
+
+	if (subnet >= 0 && subnet < (SUBNETS_NUMBER-1)){
 		if (ctp[i].subnet == -1){
 			ctp[i].producer_task = producer_task;
 			ctp[i].consumer_task = consumer_task;
@@ -69,7 +73,9 @@ CTP * add_ctp(int producer_task, int consumer_task, int dmni_op, int subnet){
 
 void remove_ctp(int subnet, int dmni_op){
 
-	for(int i=0; i<MAX_CTP; i++){
+	int i = CTP_INDEX(subnet, dmni_op);
+
+	if (subnet >= 0 && subnet < (SUBNETS_NUMBER-1)){
 		if (ctp[i].subnet == subnet && ctp[i].dmni_op == dmni_op){
 
 #if CS_DEBUG
@@ -381,7 +387,7 @@ void handle_dynamic_CS_setup(volatile ServiceHeader * p){
 
 			send_service_to_MA(qos_master_id, qos_master_addr, message, 4);
 
-			while(HAL_is_send_active(PS_SUBNET));
+			while(is_send_active(PS_SUBNET));
 
 		}
 
@@ -18,6 +18,11 @@ unsigned int 	last_idle_time;				//!< Store the last idle time duration
 unsigned int 	last_idle_time_report = 0;	//!< Store time at the last slack time update sent to manager
 unsigned int 	total_idle_time = 0;		//!< Store the total of the processor idle time
 
+#if PERF_COUNTERS
+unsigned int 	last_perf_report = 0;					//!< Store time at the last PERF_COUNTERS_REPORT
+unsigned int 	last_busy_cycles = 0;					//!< Sum of the per page cycles counters at the last report
+#endif
+
 void send_latency_miss(TCB * target_task, int producer_task, int producer_proc){
 
 	unsigned int message[5];
@@ -47,7 +52,7 @@ void send_latency_miss(TCB * target_task, int producer_task, int producer_proc){
 
 		//putsv("Master id: ", master_id);
 
-		while(HAL_is_send_active(PS_SUBNET));
+		while(is_send_active(PS_SUBNET));
 	}
 
 }
@@ -58,26 +63,112 @@ void send_slack_time_report(){
 
 	return;
 
-	unsigned int time_aux;
-
 	ServiceHeader * p = get_service_header_slot();
 
 	p->header = cluster_master_address;
 
 	p->service = SLACK_TIME_REPORT;
 
+	p->cpu_slack_time = get_slack_time();
+
+	//putsv("Slack time sent = ", p->cpu_slack_time);
+
+	send_packet(p, 0, 0);
+}
+
+/** Computes the processor slack time, i.e., the percentage of idle time since the last call
+ * \return The slack time in percentage
+ */
+unsigned int get_slack_time(){
+
+	unsigned int time_aux, window, slack;
+
 	time_aux = HAL_get_tick();
 
-	p->cpu_slack_time = ( (total_idle_time*100) / (time_aux - last_idle_time_report) );
+	window = time_aux - last_idle_time_report;
 
-	//putsv("Slack time sent = ", (total_idle_time*100) / (time_aux - last_idle_time_report));
+	if (window == 0 || total_idle_time >= window)
+		slack = 100;
+	else
+		slack = (total_idle_time*100) / window;
 
 	total_idle_time = 0;
 
 	last_idle_time_report = time_aux;
 
-	send_packet(p, 0, 0);
+	return slack;
+}
+
+#if PERF_COUNTERS
+/** Reads the per page performance counters and sends a PERF_COUNTERS_REPORT with the PE slack time, measured
+ * as the cycles without the CPU clock running, to each local mapper of the local tasks
+ */
+void send_perf_counters_report(){
+
+	unsigned int message[3];
+	unsigned int time_aux, window, busy, slack;
+	unsigned int master_addr, master_id;
+	int reported;
+	TCB * tcb_ptr;
+	TCB * other_ptr;
+
+	time_aux = HAL_get_tick();
+	window = time_aux - last_perf_report;
+	last_perf_report = time_aux;
+
+	if (window == 0)
+		return;
+
+	//Cycles are only counted while the CPU clock is running, the remaining of the window is slack
+	busy = 0;
+	for(int i=0; i<=MAX_LOCAL_TASKS; i++)
+		busy += HAL_get_perf_counter(PERF_CYCLES, i);
+
+	time_aux = busy;
+	busy -= last_busy_cycles;
+	last_busy_cycles = time_aux;
+
+	slack = (busy >= window) ? 0 : 100 - ((busy*100) / window);
+
+	message[0] = PERF_COUNTERS_REPORT;
+	message[1] = net_address;
+	message[2] = slack;
+
+	for(int i=0; i<MAX_LOCAL_TASKS; i++){
+
+		tcb_ptr = get_tcb_index_ptr(i);
+
+		if (tcb_ptr->scheduling_ptr->status == FREE || tcb_ptr->is_service_task)
+			continue;
+
+		//A single report for each local mapper
+		reported = 0;
+		for(int j=0; j<i; j++){
+			other_ptr = get_tcb_index_ptr(j);
+			if (other_ptr->scheduling_ptr->status != FREE && !other_ptr->is_service_task && other_ptr->master_address == tcb_ptr->master_address)
+				reported = 1;
+		}
+
+		if (reported)
+			continue;
+
+		//Address of the local mapper
+		master_addr = tcb_ptr->master_address & 0xFFFF;
+		master_id = tcb_ptr->master_address >> 16;
+
+		if (master_addr == net_address){
+
+			write_local_service_to_MA(master_id, message, 3);
+
+		} else {
+
+			send_service_to_MA(master_id, master_addr, message, 3);
+
+			while(is_send_active(PS_SUBNET));
+		}
+	}
 }
+#endif
 
 void init_profiling_window(){
 
@@ -22,6 +22,10 @@ inline void check_profiling_need();
 
 void send_slack_time_report();
 
+unsigned int get_slack_time();
+
+void send_perf_counters_report();
+
 inline void reset_last_idle_time();
 
 inline void compute_idle_time();
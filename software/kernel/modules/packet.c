@@ -16,38 +16,213 @@
 
 #include "packet.h"
 #include "../../hal/mips/HAL_kernel.h"
+#include "../../include/services.h"
 
-volatile ServiceHeaderSlot sh_slot1, sh_slot2;	//!<Slots to prevent memory writing while is sending a packet
+volatile ServiceHeaderSlot sh_slot[SH_SLOTS];	//!<Slots to prevent memory writing while is sending a packet
+unsigned int sh_slot_next;						//!<Next slot returned by get_service_header_slot, the slots are used in round robin
 
+#if DMNI_SEND_RING
+SendQueueEntry send_queue[SEND_QUEUE_SIZE];		//!<Packets waiting room into the DMNI send ring, in sending order
+unsigned int send_queue_first;
+unsigned int send_queue_count;
+#endif
 
-/**Searches for a free ServiceHeaderSlot (sh_slot1 or sh_slot2) pointer.
+
+#if DMNI_SEND_RING
+/**Searches the ServiceHeaderSlot that stores a ServiceHeader
+ * \param p ServiceHeader pointer
+ * \return The slot pointer, or 0 if p is not a ServiceHeader of sh_slot
+ */
+static volatile ServiceHeaderSlot * search_slot(ServiceHeader * p){
+
+	unsigned int offset = (unsigned int) p - (unsigned int) sh_slot;
+
+	if (offset >= sizeof(sh_slot) || offset % sizeof(ServiceHeaderSlot))
+		return 0;
+
+	return &sh_slot[offset / sizeof(ServiceHeaderSlot)];
+}
+#endif
+
+/**Searches for a free ServiceHeaderSlot pointer.
  * A free slot is the one which is not being used by DMNI. This function prevents that
  * a given memory space be changed while its is not completely transmitted by DMNI.
+ * The slots are taken in round robin, so up to SH_SLOTS packets are in flight before the kernel waits
  * \return A pointer to a free ServiceHeadeSlot
  */
 ServiceHeader * get_service_header_slot() {
 
-	if ( sh_slot1.status ) {
+	volatile ServiceHeaderSlot * slot;
 
-		sh_slot1.status = 0;
-		sh_slot2.status = 1;
-		return (ServiceHeader*) &sh_slot1.service_header;
+	slot = &sh_slot[sh_slot_next];
 
-	} else {
+	sh_slot_next = (sh_slot_next + 1) % SH_SLOTS;
 
-		sh_slot2.status = 0;
-		sh_slot1.status = 1;
-		return (ServiceHeader*) &sh_slot2.service_header;
-	}
+#if DMNI_SEND_RING
+	//The last packet of this slot can still be into the send queue or into the send ring
+	while ( slot->status || (int)(DMNI_send_ring_done() - slot->ring_seq) < 0 )
+		send_queue_drain();
+#endif
+
+	return (ServiceHeader*) &slot->service_header;
 }
 
 /**Initializes the service slots
  */
 void init_packet(){
-	sh_slot1.status = 1;
-	sh_slot2.status = 1;
+
+	for(int i=0; i<SH_SLOTS; i++){
+		sh_slot[i].status = 0;
+		sh_slot[i].ring_seq = 0;
+	}
+
+	sh_slot_next = 0;
+
+#if DMNI_SEND_RING
+	send_queue_first = 0;
+	send_queue_count = 0;
+#endif
+}
+
+#if DMNI_SEND_RING
+/**Pushes a packet into the DMNI send ring and keeps its sequence number into its slot
+ * \param p Packet pointer
+ * \param initial_address Initial memory address of the packet payload
+ * \param dmni_msg_size Packet payload size represented in memory words of 32 bits
+ */
+static void send_ring_push(ServiceHeader * p, unsigned int initial_address, unsigned int dmni_msg_size){
+
+	volatile ServiceHeaderSlot * slot = search_slot(p);
+	unsigned int seq;
+
+	seq = DMNI_send_ring_push((unsigned int) p, CONSTANT_PKT_SIZE, initial_address, dmni_msg_size);
+
+	if (slot){
+		slot->ring_seq = seq;
+		slot->status = 0;
+	}
+}
+
+/**Moves the packets of the send queue into the DMNI send ring while it has room.
+ * Called by the IRQ_DMNI_RING interrupt, which is enabled only while the queue has packets, and
+ * by the kernel loops that wait for a packet to be sent, since the kernel runs with the interrupts disabled
+ */
+void send_queue_drain(){
+
+	SendQueueEntry * entry;
+
+	if (send_queue_count == 0)
+		return;
+
+	//Completions after this point raise the interrupt again
+	DMNI_send_ring_ack(DMNI_send_ring_done());
+
+	while (send_queue_count){
+
+		entry = &send_queue[send_queue_first];
+
+		if (DMNI_send_ring_free() < ((entry->dmni_msg_size > 0) ? 2 : 1))
+			return;
+
+		send_ring_push(entry->service_header, entry->initial_address, entry->dmni_msg_size);
+
+		send_queue_first = (send_queue_first + 1) % SEND_QUEUE_SIZE;
+		send_queue_count--;
+	}
+
+	HAL_interrupt_mask_clear(IRQ_DMNI_RING);
 }
+#endif
+
+/**Tests if a subnet still has data to send. For the PS subnet it includes the packets of the send queue,
+ * so the kernel uses it in place of HAL_is_send_active()
+ * \param subnet Number of the subnet
+ * \return Not zero if there are data not sent, 0 otherwise
+ */
+int is_send_active(unsigned int subnet){
+
+#if DMNI_SEND_RING
+	if (subnet == PS_SUBNET){
 
+		send_queue_drain();
+
+		if (send_queue_count)
+			return 1;
+	}
+#endif
+
+	return HAL_is_send_active(subnet);
+}
+
+/**Adds to an interrupt mask the send queue interrupt. A service task runs with all interrupts cleared,
+ * so IRQ_DMNI_RING must be restored together with the kernel mask while the queue has packets
+ * \param mask Interrupt mask to be set
+ * \return The mask with IRQ_DMNI_RING while the send queue has packets
+ */
+unsigned int send_queue_mask(unsigned int mask){
+
+#if DMNI_SEND_RING
+	if (send_queue_count)
+		return mask | IRQ_DMNI_RING;
+#endif
+
+	return mask;
+}
+
+
+/**Tests if a service belongs to the control-plane (mapping, SDN, QoS and MA management) traffic.
+ * These packets are sent with the PRIORITY_PKT flag, so the routers arbitrate them ahead of
+ * the bulk MESSAGE_DELIVERY, TASK_ALLOCATION and migration traffic. It is also used by SENDRAW
+ * for the raw packets of the management tasks
+ * \param service Service code (see services.h)
+ * \return 1 if the service is a management service, 0 otherwise
+ */
+int is_management_service(unsigned int service){
+
+	switch (service) {
+		case TASK_ALLOCATED:
+		case CODE_CACHE_MISS:
+		case TASK_TERMINATED:
+		case TASK_TERMINATED_OTHER_CLUSTER:
+		case TASK_RELEASE:
+		case INITIALIZE_SLAVE:
+		case APP_ALLOCATED:
+		case APP_TERMINATED:
+		case APP_ALLOCATION_REQUEST:
+		case NEW_APP_REQ:
+		case NEW_APP:
+		case INIT_I_AM_ALIVE:
+		case INITIALIZE_MA_TASK:
+		case LOAN_PROCESSOR_REQUEST:
+		case LOAN_PROCESSOR_DELIVERY:
+		case LOAN_PROCESSOR_RELEASE:
+		case CLEAR_CS_CTP:
+		case SET_NOC_SWITCHING_CONSUMER:
+		case SET_NOC_SWITCHING_PRODUCER:
+		case NOC_SWITCHING_PRODUCER_ACK:
+		case NOC_SWITCHING_CTP_CONCLUDED:
+		case DETAILED_ROUTING_REQUEST:
+		case DETAILED_ROUTING_RESPONSE:
+		case TOKEN_REQUEST:
+		case TOKEN_RELEASE:
+		case TOKEN_GRANT:
+		case UPDATE_BORDER_REQUEST:
+		case UPDATE_BORDER_ACK:
+		case LOCAL_RELEASE_REQUEST:
+		case LOCAL_RELEASE_ACK:
+		case GLOBAL_MODE_RELEASE:
+		case GLOBAL_MODE_RELEASE_ACK:
+		case PATH_CONNECTION_REQUEST:
+		case PATH_CONNECTION_RELEASE:
+		case PATH_CONNECTION_ACK:
+		case NI_STATUS_REQUEST:
+		case NI_STATUS_RESPONSE:
+		case SDN_FAULT_REPORT:
+			return 1;
+	}
+
+	return 0;
+}
 
 /**Function that abstracts the process to send a generic packet to NoC by programming the DMNI
  * \param p Packet pointer
@@ -56,12 +231,51 @@ void init_packet(){
  */
 void send_packet(ServiceHeader *p, unsigned int initial_address, unsigned int dmni_msg_size){
 
+#if DMNI_SEND_RING
+	volatile ServiceHeaderSlot * slot;
+	SendQueueEntry * entry;
+#endif
+
 	p->payload_size = (CONSTANT_PKT_SIZE - 2) + dmni_msg_size;
 
 	//p->cpu_slack_time = 0;
 
 	p->source_PE = net_address;
 
+	if (is_management_service(p->service))
+		p->header |= PRIORITY_PKT;
+
+#if DMNI_SEND_RING
+	p->timestamp = HAL_get_tick();
+
+	//Queues the packet and returns, the DMNI drains the ring while the kernel keeps running
+	send_queue_drain();
+
+	if (send_queue_count == 0 && DMNI_send_ring_free() >= ((dmni_msg_size > 0) ? 2 : 1)){
+		send_ring_push(p, initial_address, dmni_msg_size);
+		return;
+	}
+
+	//The ring is full, the packet waits into the send queue, which keeps the sending order
+	while (send_queue_count == SEND_QUEUE_SIZE)
+		send_queue_drain();
+
+	if (send_queue_count == 0){
+		DMNI_send_ring_ack(DMNI_send_ring_done());
+		HAL_interrupt_mask_set(IRQ_DMNI_RING);
+	}
+
+	entry = &send_queue[(send_queue_first + send_queue_count) % SEND_QUEUE_SIZE];
+	entry->service_header = p;
+	entry->initial_address = initial_address;
+	entry->dmni_msg_size = dmni_msg_size;
+	send_queue_count++;
+
+	slot = search_slot(p);
+	if (slot)
+		slot->status = 1;
+
+#else
 	//Waits the DMNI send process be released
 	while ( HAL_is_send_active(PS_SUBNET) );
 
@@ -77,6 +291,7 @@ void send_packet(ServiceHeader *p, unsigned int initial_address, unsigned int dm
 
 	HAL_set_dmni_mem_addr((unsigned int) p);
 	HAL_set_dmni_mem_size(CONSTANT_PKT_SIZE);
+#endif
 
 }
 
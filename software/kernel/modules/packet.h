@@ -19,6 +19,10 @@
 
 #define PS_SUBNET (SUBNETS_NUMBER-1)
 #define CONSTANT_PKT_SIZE	13	//!<Constant Service Header size, based on the structure ServiceHeader.
+#define PRIORITY_PKT		0x10000000	//!<Header flit bit 28, gives the packet precedence in the PS router arbiter (see PRIORITY_BIT in standards.h)
+#define MSG_REQUEST_PKT		0x08000000	//!<Header flit bit 27, the MESSAGE_REQUEST is absorbed by the target hardware message request table (see MSG_REQUEST_BIT in standards.h)
+#define SH_SLOTS			8	//!<ServiceHeader slots, a slot is reused only after its packet was sent
+#define SEND_QUEUE_SIZE		8	//!<Packets waiting room into the DMNI send ring, the queue is drained by the IRQ_DMNI_RING interrupt
 
 /**
  * \brief This structure is in charge to defines the ServiceHeader field that can be filled by the software part
@@ -54,6 +58,7 @@ typedef struct {
 	union {
 		unsigned int cpu_slack_time;			//!<Unused field for while
 		unsigned int computation_task_number;
+		unsigned int code_hash;					//!<TASK_ALLOCATION: hash of the task TEXT section, used to tag the page into the task code cache
 	};
 	//flit 8
 	union {								//!<Generic union
@@ -71,6 +76,7 @@ typedef struct {
 		unsigned int producer_processor;
 		unsigned int target_processor;
 		unsigned int input_port;
+		unsigned int cached_code;		//!<TASK_ALLOCATION: 1 when only the DATA section is sent, the TEXT section is in a free page tagged with code_hash
 	};
 	//flit 9
 	union {								//!<Generic union
@@ -82,6 +88,7 @@ typedef struct {
 		unsigned int consumer_processor;
 		unsigned int insert_request;
 		unsigned int task_number;
+		unsigned int credits;			//!<MESSAGE_CREDIT and MESSAGE_CREDIT_REVOKE: number of credits. MESSAGE_DELIVERY: 1 when the message was pushed with a credit (eager)
 	};
 	//flit 10
 	union {								//!<Generic union
@@ -105,6 +112,7 @@ typedef struct {
 	//flit 12
 	union {								//!<Generic union
 		unsigned int initial_address;
+		unsigned int compressed_code_size;	//!<TASK_ALLOCATION: size in words of the compressed task code, 0 when the code is not compressed
 		unsigned int program_counter;
 		unsigned int utilization;
 	};
@@ -119,15 +127,33 @@ typedef struct {
 typedef struct {
 
 	ServiceHeader service_header;
-	unsigned int status;
+	unsigned int status;		//!<1 while the packet of this slot waits into the send queue
+	unsigned int ring_seq;		//!<Send ring sequence number of the last packet sent from this slot (see DMNI_send_ring_push)
 
 }ServiceHeaderSlot;
 
+/**
+ * \brief This structure stores a packet which did not fit into the DMNI send ring
+ */
+typedef struct {
+
+	ServiceHeader * service_header;
+	unsigned int initial_address;	//!<Payload address
+	unsigned int dmni_msg_size;		//!<Payload size
+
+}SendQueueEntry;
+
 
 ServiceHeader* get_service_header_slot();
 
 void init_packet();
 
+void send_queue_drain();
+
+int is_send_active(unsigned int);
+
+unsigned int send_queue_mask(unsigned int);
+
 inline unsigned int DMNI_read_data_CS(unsigned int, unsigned int);
 
 void DMNI_read_data(unsigned int, unsigned int);
@@ -136,6 +162,8 @@ void DMNI_send_data(unsigned int, unsigned int, unsigned int);
 
 void send_packet(ServiceHeader *, unsigned int, unsigned int);
 
+int is_management_service(unsigned int);
+
 void read_packet(ServiceHeader *);
 
 void config_subnet(unsigned int, unsigned int, unsigned int);
@@ -10,6 +10,8 @@
  * \brief
  * This module implements function relative a FIFO of the incomming packets (ServiceHeader FIFO) received by slave and that cannot be
  * immediately handled.
+ * When the FIFO becomes full the kernel stops reading the PS packets (backpressure), the next ones wait into the DMNI and into
+ * the NoC until the FIFO is drained to PENDING_SERVICE_RESUME.
  * This modules is used only by the slave kernel
  */
 
@@ -24,6 +26,15 @@ unsigned int pending_service_last = 0;	//!<last valid array index
 
 unsigned char add_fifo = 0; 	//!<Keeps the last operation: 1 - last operation was add. 0 - last operation was remove
 
+unsigned int pending_service_count = 0;	//!<Number of pending services into the FIFO
+unsigned char backpressure = 0;			//!<1 while the kernel does not read the PS packets
+
+#if MSG_REQUEST_TABLE
+#define BACKPRESSURE_IRQ	(IRQ_PS | IRQ_MSG_REQUEST)	//!<Interrupts that add pending services
+#else
+#define BACKPRESSURE_IRQ	IRQ_PS
+#endif
+
 
 /**Add a new pending service. A pending service is a incoming service that cannot be handled immediately by kernel
  * \param pending_service Incoming ServiceHeader pointer
@@ -33,7 +44,7 @@ unsigned char add_pending_service(ServiceHeader * pending_service){
 
 	ServiceHeader * fifo_free_position;
 
-	//Test if the buffer is full
+	//Test if the buffer is full, it cannot happen since the interrupts that add services are masked when the FIFO becomes full
 	if (pending_service_first == pending_service_last && add_fifo == 1){
 		puts("ERROR: Pending service FIFO FULL\n");
 		while(1);
@@ -56,6 +67,12 @@ unsigned char add_pending_service(ServiceHeader * pending_service){
 	//puts("Interruption set ON\n");
 	HAL_set_pending_service(1);
 
+	//Backpressure: the PS packets are left into the NoC until the kernel handles the pending services
+	if (++pending_service_count == PENDING_SERVICE_TAM){
+		HAL_interrupt_mask_clear(BACKPRESSURE_IRQ);
+		backpressure = 1;
+	}
+
 	return 1;
 }
 
@@ -82,6 +99,13 @@ ServiceHeader * get_next_pending_service(){
 
 	add_fifo = 0;
 
+	pending_service_count--;
+
+	if (backpressure && pending_service_count <= PENDING_SERVICE_RESUME){
+		HAL_interrupt_mask_set(BACKPRESSURE_IRQ);
+		backpressure = 0;
+	}
+
 	//Test if the buffer is empty
 	if (pending_service_first == pending_service_last){
 		//puts("Interruption set OFF\n");
@@ -90,3 +114,15 @@ ServiceHeader * get_next_pending_service(){
 
 	return service_header_to_ret;
 }
+
+/**Removes from an interrupt mask the interrupts held by the backpressure
+ * \param mask Interrupt mask to be set
+ * \return The mask without IRQ_PS (and IRQ_MSG_REQUEST) while the pending service FIFO is full
+ */
+unsigned int pending_service_mask(unsigned int mask){
+
+	if (backpressure)
+		return mask & ~BACKPRESSURE_IRQ;
+
+	return mask;
+}
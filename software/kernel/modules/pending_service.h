@@ -18,9 +18,12 @@
 #include "packet.h"
 
 #define PENDING_SERVICE_TAM		20		//!<Pending service array size
+#define PENDING_SERVICE_RESUME	(PENDING_SERVICE_TAM/2)	//!<Occupancy under which the kernel reads again the PS packets after a backpressure
 
 unsigned char add_pending_service(ServiceHeader *);
 
 ServiceHeader * get_next_pending_service();
 
+unsigned int pending_service_mask(unsigned int);
+
 #endif /* SOFTWARE_INCLUDE_PENDING_SERVICE_PENDING_SERVICE_H_ */
@@ -25,9 +25,29 @@
 
 
 MessageRequest message_request[REQUEST_SIZE];	//!< message request array
+int 			request_head[MAX_LOCAL_TASKS];	//!< First message_request entry of each local producer, indexed by TCB
+int 			request_free;					//!< First free message_request entry
+
+#if MSG_REQUEST_TABLE
+MessageRequest table_request;					//!< Request matched by the hardware message request table
+#endif
 
 unsigned int 	averange_latency = 500;				//!< Stores the averange latency
 
+AsyncTable 		async_table[MAX_LOCAL_TASKS];	//!< Non-blocking operations of each local task, indexed by TCB
+
+#if OUTBOX_DEPTH
+Outbox 			outbox[MAX_LOCAL_TASKS];		//!< Outbox of each local task, indexed by TCB
+#endif
+
+#if EAGER_MESSAGING
+EagerPair 		eager_pair[REQUEST_SIZE];		//!< Consumer side of the remote pairs with local consumer
+EagerCredit 	eager_credit[REQUEST_SIZE];		//!< Producer side of the remote pairs with local producer
+EagerBuffer 	eager_buffer[EAGER_BUFFERS];	//!< Kernel receive buffer pool
+unsigned int 	eager_reserved = 0;				//!< Buffers reserved by the quota of the eager_pair entries
+unsigned int 	eager_order = 0;				//!< Arrival counter of the eager_buffer entries
+#endif
+
 /** Initializes the message request and the pipe array
  */
 void init_communication(){
@@ -36,108 +56,374 @@ void init_communication(){
 		message_request[i].requested = -1;
 		message_request[i].requester = -1;
 		message_request[i].requester_proc = -1;
+		message_request[i].next = i+1;
+	}
+	message_request[REQUEST_SIZE-1].next = -1;
+	request_free = 0;
+
+	for(int t=0; t<MAX_LOCAL_TASKS; t++)
+		request_head[t] = -1;
+
+	for(int t=0; t<MAX_LOCAL_TASKS; t++){
+		for(int i=0; i<ASYNC_REQUESTS; i++)
+			async_table[t].request[i].type = ASYNC_FREE;
+		async_table[t].waiting = ASYNC_WAIT_NONE;
+		async_table[t].pending_sends = 0;
+		async_table[t].order = 0;
 	}
+
+#if OUTBOX_DEPTH
+	for(int t=0; t<MAX_LOCAL_TASKS; t++){
+		for(int i=0; i<MAX_TASKS_APP; i++){
+			outbox[t].head[i] = -1;
+			outbox[t].tail[i] = -1;
+		}
+		for(int i=0; i<OUTBOX_DEPTH; i++)
+			outbox[t].slot[i].next = i+1;
+		outbox[t].slot[OUTBOX_DEPTH-1].next = -1;
+		outbox[t].free = 0;
+		outbox[t].count = 0;
+	}
+#endif
+
+#if EAGER_MESSAGING
+	for(int i=0; i<REQUEST_SIZE; i++){
+		eager_pair[i].producer = -1;
+		eager_credit[i].producer = -1;
+	}
+	for(int i=0; i<EAGER_BUFFERS; i++)
+		eager_buffer[i].producer = -1;
+#endif
 }
 
 
-/** Inserts a message request into the message_request array
- *  \param producer_task ID of the producer task of the message
+/** Inserts a message request into the request list of a local producer
+ *  \param prod_tcb_ptr TCB pointer of the producer task of the message
  *  \param consumer_task ID of the consumer task of the message
  *  \param requester_proc Processor of the consumer task
  *  \return 0 if the message_request array is full, 1 if the message was successfully inserted
  */
-int insert_message_request(int producer_task, int consumer_task, int requester_proc) {
+int insert_message_request(TCB * prod_tcb_ptr, int consumer_task, int requester_proc) {
 
-    int i;
+	int i = request_free;
+	int prod_index;
 
-    for (i=0; i<REQUEST_SIZE; i++)
-    	if ( message_request[i].requester == -1 ) {
-    		message_request[i].requester  = consumer_task;
-    		message_request[i].requested  = producer_task;
-    		message_request[i].requester_proc = requester_proc;
+	if (prod_tcb_ptr == 0 || i == -1){
+		puts("ERROR - request table if full\n");
+		return 0;	/*no space in table*/
+	}
 
-    		//Only for debug purposes
-    		//MemoryWrite(ADD_REQUEST_DEBUG, (producer_task << 16) | (consumer_task & 0xFFFF));
-    		HAL_add_request_debug((producer_task << 16) | (consumer_task & 0xFFFF));
+	prod_index = prod_tcb_ptr - get_tcb_index_ptr(0);
 
-    		return 1;
-		}
+	request_free = message_request[i].next;
+
+	message_request[i].requester  = consumer_task;
+	message_request[i].requested  = prod_tcb_ptr->id;
+	message_request[i].requester_proc = requester_proc;
+
+	message_request[i].next = request_head[prod_index];
+	request_head[prod_index] = i;
 
-    puts("ERROR - request table if full\n");
-	return 0;	/*no space in table*/
+	//Only for debug purposes
+	//MemoryWrite(ADD_REQUEST_DEBUG, (producer_task << 16) | (consumer_task & 0xFFFF));
+	HAL_add_request_debug((prod_tcb_ptr->id << 16) | (consumer_task & 0xFFFF));
+
+	return 1;
 }
 
 /** Searches for a message request
- *  \param producer_task ID of the producer task of the message
+ *  \param prod_tcb_ptr TCB pointer of the producer task of the message
  *  \param consumer_task ID of the consumer task of the message
  *  \return 0 if the message was not found, 1 if the message was found
  */
-int search_message_request(int producer_task, int consumer_task) {
+int search_message_request(TCB * prod_tcb_ptr, int consumer_task) {
 
-    for(int i=0; i<REQUEST_SIZE; i++) {
-        if( message_request[i].requested == producer_task && message_request[i].requester == consumer_task){
-            return 1;
-        }
-    }
+	for(int i = request_head[prod_tcb_ptr - get_tcb_index_ptr(0)]; i != -1; i = message_request[i].next) {
+		if( message_request[i].requester == consumer_task){
+			return 1;
+		}
+	}
 
-    return 0;
+	return 0;
 }
 
 /** Remove a message request
- *  \param producer_task ID of the producer task of the message
+ *  \param prod_tcb_ptr TCB pointer of the producer task of the message
  *  \param consumer_task ID of the consumer task of the message
- *  \return -1 if the message was not found or the requester processor address (processor of the consumer task)
+ *  \return 0 if the message was not found or the request, valid until the next insert_message_request
  */
-MessageRequest * remove_message_request(int producer_task, int consumer_task) {
+MessageRequest * remove_message_request(TCB * prod_tcb_ptr, int consumer_task) {
 
-    for(int i=0; i<REQUEST_SIZE; i++) {
-        if( message_request[i].requested == producer_task && message_request[i].requester == consumer_task){
-        	message_request[i].requester = -1;
-        	message_request[i].requested = -1;
+	int producer_task = prod_tcb_ptr->id;
+	int * link = &request_head[prod_tcb_ptr - get_tcb_index_ptr(0)];
+	int i;
 
-        	//Only for debug purposes
-        	//MemoryWrite(REM_REQUEST_DEBUG, (producer_task << 16) | (consumer_task & 0xFFFF));
-        	HAL_remv_request_debug((producer_task << 16) | (consumer_task & 0xFFFF));
+	for(i = *link; i != -1; link = &message_request[i].next, i = *link) {
+		if( message_request[i].requester == consumer_task){
+
+			//Unlinks the entry and moves it to the free list
+			*link = message_request[i].next;
+			message_request[i].next = request_free;
+			request_free = i;
+
+			message_request[i].requester = -1;
+			message_request[i].requested = -1;
 
-            //return message_request[i].requester_proc;
-        	return &message_request[i];
-        }
+			//Only for debug purposes
+			//MemoryWrite(REM_REQUEST_DEBUG, (producer_task << 16) | (consumer_task & 0xFFFF));
+			HAL_remv_request_debug((producer_task << 16) | (consumer_task & 0xFFFF));
+
+			return &message_request[i];
+		}
+	}
+
+#if MSG_REQUEST_TABLE
+    //Requests received by PS are absorbed by the hardware table, the entry is removed by the match
+    HAL_msg_request_match((producer_task << 16) | (consumer_task & 0xFFFF));
+    table_request.requester_proc = HAL_get_msg_request_result();
+
+    if (table_request.requester_proc != -1){
+    	table_request.requested = producer_task;
+    	table_request.requester = consumer_task;
+
+    	HAL_remv_request_debug((producer_task << 16) | (consumer_task & 0xFFFF));
+
+    	return &table_request;
     }
+#endif
 
     return 0;
 }
 
-/**Remove all message request of a requested task ID and copies such messages to the removed_msgs array.
+/**Remove all message request of a requested task and copies such messages to the removed_msgs array.
  * This function is used for task migration only, when a task need to be moved to other processor
- *  \param requested_task ID of the requested task
+ *  \param prod_tcb_ptr TCB pointer of the requested task
  *  \param removed_msgs array pointer of the removed messages
  *  \return number of removed messages
  */
-int remove_all_requested_msgs(int requested_task, unsigned int * removed_msgs){
+int remove_all_requested_msgs(TCB * prod_tcb_ptr, unsigned int * removed_msgs){
 
 	int request_index = 0;
+	int prod_index = prod_tcb_ptr - get_tcb_index_ptr(0);
+	int i;
 
-	for(int i=0; i<REQUEST_SIZE; i++) {
+	while ((i = request_head[prod_index]) != -1) {
 
-		if (message_request[i].requested == requested_task){
+		//Copies the messages to the array
+		removed_msgs[request_index++] = message_request[i].requester;
+		removed_msgs[request_index++] = message_request[i].requested;
+		removed_msgs[request_index++] = message_request[i].requester_proc;
 
-			//Copies the messages to the array
-			removed_msgs[request_index++] = message_request[i].requester;
-			removed_msgs[request_index++] = message_request[i].requested;
-			removed_msgs[request_index++] = message_request[i].requester_proc;
+		//Only for debug purposes
+		//MemoryWrite(REM_REQUEST_DEBUG, (message_request[i].requester << 16) | (message_request[i].requested & 0xFFFF));
 
-        	//Only for debug purposes
-			//MemoryWrite(REM_REQUEST_DEBUG, (message_request[i].requester << 16) | (message_request[i].requested & 0xFFFF));
+		//Removes the message request
+		request_head[prod_index] = message_request[i].next;
+		message_request[i].next = request_free;
+		request_free = i;
 
-			//Removes the message request
-			message_request[i].requester = -1;
-			message_request[i].requested = -1;
-		}
+		message_request[i].requester = -1;
+		message_request[i].requested = -1;
 	}
 
+#if MSG_REQUEST_TABLE
+	//Drains the requests absorbed by the hardware table, set_local_producer must be called before
+	HAL_msg_request_match_prod(prod_tcb_ptr->id);
+
+	while (HAL_get_msg_request_result() != -1){
+
+		removed_msgs[request_index++] = HAL_get_msg_request_tasks() & 0xFFFF;
+		removed_msgs[request_index++] = prod_tcb_ptr->id;
+		removed_msgs[request_index++] = HAL_get_msg_request_result();
+
+		HAL_msg_request_match_prod(prod_tcb_ptr->id);
+	}
+#endif
+
 	return request_index;
 }
 
+/**Registers the task of a TCB as a local producer into the hardware message request table.
+ * The table only absorbs the MESSAGE_REQUEST of local producers, the others are forwarded by the kernel
+ *  \param tcb_ptr TCB pointer of the producer task
+ *  \param task_id ID of the task, -1 to unregister the TCB
+ */
+void set_local_producer(TCB * tcb_ptr, int task_id){
+
+#if MSG_REQUEST_TABLE
+	HAL_set_msg_request_task(tcb_ptr - get_tcb_index_ptr(0), task_id);
+#endif
+}
+
+/** Registers a local producer into the hardware message request table only while the kernel has no message
+ * of it waiting a MESSAGE_REQUEST (outbox or ISend), otherwise the requests must reach the kernel.
+ * The requests already absorbed by the table are signaled as orphans when the producer is unregistered
+ *  \param tcb_ptr TCB pointer of the producer task
+ */
+static void update_local_producer(TCB * tcb_ptr){
+
+	int index = tcb_ptr - get_tcb_index_ptr(0);
+	int buffered = async_table[index].pending_sends;
+
+#if OUTBOX_DEPTH
+	buffered += outbox[index].count;
+#endif
+
+	set_local_producer(tcb_ptr, buffered ? -1 : tcb_ptr->id);
+}
+
+#if OUTBOX_DEPTH
+/** Copies a message into the outbox of the producer, so the Send returns before the MESSAGE_REQUEST
+ * \param prod_tcb_ptr TCB pointer of the producer task
+ * \param consumer_task ID of the consumer task
+ * \param msg_ptr Message pointer
+ * \return 1 if the message was stored, 0 if the outbox is full or the message is larger than OUTBOX_MSG_WORDS
+ */
+static int outbox_push(TCB * prod_tcb_ptr, int consumer_task, Message * msg_ptr){
+
+	Outbox * box = &outbox[prod_tcb_ptr - get_tcb_index_ptr(0)];
+	unsigned int cons_index = consumer_task & 0xFF;
+	int s;
+
+	if (box->free == -1 || msg_ptr->length > OUTBOX_MSG_WORDS)
+		return 0;
+
+	s = box->free;
+	box->free = box->slot[s].next;
+
+	box->slot[s].length = msg_ptr->length;
+	DMNI_copy_start((unsigned int) box->slot[s].msg, (unsigned int) msg_ptr->msg, msg_ptr->length);
+
+	box->slot[s].next = -1;
+	if (box->head[cons_index] == -1)
+		box->head[cons_index] = s;
+	else
+		box->slot[box->tail[cons_index]].next = s;
+	box->tail[cons_index] = s;
+
+	if (box->count++ == 0)
+		update_local_producer(prod_tcb_ptr);
+
+	//The producer may reuse its message after the syscall
+	DMNI_copy_wait();
+
+	return 1;
+}
+
+/** Gets the oldest message of the outbox addressed to a consumer
+ * \param prod_tcb_ptr TCB pointer of the producer task
+ * \param consumer_task ID of the consumer task
+ * \return Message pointer, 0 if there is no message to the consumer
+ */
+static Message * outbox_front(TCB * prod_tcb_ptr, int consumer_task){
+
+	Outbox * box = &outbox[prod_tcb_ptr - get_tcb_index_ptr(0)];
+	int s = box->head[consumer_task & 0xFF];
+
+	if (s == -1)
+		return 0;
+
+	return (Message *) &box->slot[s].length;
+}
+
+/** Releases the oldest message of the outbox addressed to a consumer
+ * \param prod_tcb_ptr TCB pointer of the producer task
+ * \param consumer_task ID of the consumer task
+ */
+static void outbox_pop(TCB * prod_tcb_ptr, int consumer_task){
+
+	Outbox * box = &outbox[prod_tcb_ptr - get_tcb_index_ptr(0)];
+	unsigned int cons_index = consumer_task & 0xFF;
+	int s = box->head[cons_index];
+
+	box->head[cons_index] = box->slot[s].next;
+	if (box->head[cons_index] == -1)
+		box->tail[cons_index] = -1;
+
+	box->slot[s].next = box->free;
+	box->free = s;
+
+	if (--box->count == 0)
+		update_local_producer(prod_tcb_ptr);
+}
+
+/** Gets the number of messages kept by the outbox of a task
+ * \param tcb_ptr TCB pointer of the task
+ * \return Number of buffered messages
+ */
+int outbox_count(TCB * tcb_ptr){
+
+	return outbox[tcb_ptr - get_tcb_index_ptr(0)].count;
+}
+#endif
+
+/** Gets the oldest pending operation of a task with a given peer
+ * \param tcb_ptr TCB pointer of the task
+ * \param type ASYNC_SEND or ASYNC_RECV
+ * \param peer_task ID of the consumer (ISend) or producer (IRecv) task
+ * \return AsyncRequest pointer, 0 if not found
+ */
+static AsyncRequest * search_async_request(TCB * tcb_ptr, int type, int peer_task){
+
+	AsyncTable * table = &async_table[tcb_ptr - get_tcb_index_ptr(0)];
+	AsyncRequest * found = 0;
+
+	for(int i=0; i<ASYNC_REQUESTS; i++){
+		if (table->request[i].type == type && table->request[i].peer == peer_task && !table->request[i].done){
+			if (found == 0 || (int)(table->request[i].order - found->order) < 0)
+				found = &table->request[i];
+		}
+	}
+
+	return found;
+}
+
+/** Completes a pending operation, releasing the task when it is blocked into Wait or WaitAny
+ * \param tcb_ptr TCB pointer of the task
+ * \param req_ptr AsyncRequest pointer
+ */
+static void complete_async_request(TCB * tcb_ptr, AsyncRequest * req_ptr){
+
+	AsyncTable * table = &async_table[tcb_ptr - get_tcb_index_ptr(0)];
+	int handle = req_ptr - table->request;
+
+	if (req_ptr->type == ASYNC_SEND && --table->pending_sends == 0)
+		update_local_producer(tcb_ptr);
+
+	if (table->waiting == handle || table->waiting == ASYNC_WAIT_ANY){
+
+		if (table->waiting == ASYNC_WAIT_ANY)
+			*((int *) table->any_addr) = handle + 1;
+
+		req_ptr->type = ASYNC_FREE;
+		table->waiting = ASYNC_WAIT_NONE;
+
+		HAL_release_waiting_task(tcb_ptr);
+
+	} else {
+
+		req_ptr->done = 1;
+	}
+}
+
+/** Copies a message to the buffer of an IRecv and completes it
+ * \param tcb_ptr TCB pointer of the consumer task
+ * \param req_ptr AsyncRequest pointer of the IRecv
+ * \param msg_ptr Message pointer
+ */
+static void write_async_msg(TCB * tcb_ptr, AsyncRequest * req_ptr, Message * msg_ptr){
+
+	Message * recv_msg_ptr = (Message *) req_ptr->buffer;
+
+	recv_msg_ptr->length = msg_ptr->length;
+
+	DMNI_copy_start((unsigned int) recv_msg_ptr->msg, (unsigned int) msg_ptr->msg, msg_ptr->length);
+
+	complete_async_request(tcb_ptr, req_ptr);
+
+	DMNI_copy_wait();
+}
+
 /** Useful function to writes a message into the task page space
  * \param task_tcb_ptr TCB pointer of the task
  * \param msg_lenght Lenght of the message to be copied
@@ -151,8 +437,8 @@ void write_local_msg_to_task(TCB * consumer_tcb_ptr, int msg_lenght, int * msg_d
 
 	msg_ptr->length = msg_lenght;
 
-	for (int i=0; i<msg_ptr->length; i++)
-		msg_ptr->msg[i] = msg_data[i];
+	//The DMNI copies while the consumer is released
+	DMNI_copy_start((unsigned int) msg_ptr->msg, (unsigned int) msg_data, msg_lenght);
 
 #if DEBUG_USER_COMM
 	puts("write local msg - CONS released waiting\n");
@@ -166,6 +452,7 @@ void write_local_msg_to_task(TCB * consumer_tcb_ptr, int msg_lenght, int * msg_d
 	consumer_tcb_ptr->total_comm += HAL_get_tick() - consumer_tcb_ptr->communication_time;
 	//puts("["); puts(itoa(task_tcb_ptr->id)); puts("] Comm ==> "); puts(itoa(current->communication_time)); puts("\n");
 
+	DMNI_copy_wait();
 
 }
 
@@ -193,6 +480,10 @@ void send_message_request(int producer_task, int consumer_task, unsigned int tar
 
 		p->header = targetPE;
 
+#if MSG_REQUEST_TABLE
+		p->header |= MSG_REQUEST_PKT;
+#endif
+
 		p->service = MESSAGE_REQUEST;
 
 		p->requesting_processor = requestingPE;
@@ -231,6 +522,8 @@ void send_message_delivery(int producer_task, int consumer_task, int consumer_PE
 
 		p->msg_lenght = msg_ptr->length;
 
+		p->credits = 0;
+
 		send_packet(p, (unsigned int)msg_ptr->msg, msg_ptr->length);
 
 	} else { //the communication is by CS
@@ -246,7 +539,12 @@ void send_message_delivery(int producer_task, int consumer_task, int consumer_PE
 int handle_message_request(volatile ServiceHeader * p){
 
 	int producer_PE;
+	int subnet;
 	TCB * prod_tcb_ptr;
+	AsyncRequest * async_ptr;
+#if OUTBOX_DEPTH
+	Message * msg_ptr;
+#endif
 
 #if DEBUG_USER_COMM
 	puts("MESSAGE_REQUEST from "); puts(itoa(p->consumer_task)); puts(" to ");
@@ -259,8 +557,52 @@ int handle_message_request(volatile ServiceHeader * p){
 	//If the producer task still executing here
 	if (prod_tcb_ptr){
 
+#if OUTBOX_DEPTH
+		//The message was already sent to the outbox, it is delivered without waiting the producer
+		msg_ptr = outbox_front(prod_tcb_ptr, p->consumer_task);
+
+		if (msg_ptr){
+
+			subnet = get_subnet(p->producer_task, p->consumer_task, DMNI_SEND_OP);
+			if (subnet == -1)
+				subnet = PS_SUBNET;
+
+			while (is_send_active(subnet));
+
+			send_message_delivery(p->producer_task, p->consumer_task, p->requesting_processor, msg_ptr);
+
+			//The slot is released after the DMNI reads it
+			while (is_send_active(subnet));
+
+			outbox_pop(prod_tcb_ptr, p->consumer_task);
+
+			return 0;
+		}
+#endif
+
+		//The producer started an ISend to the consumer, the message is delivered from the producer page
+		async_ptr = search_async_request(prod_tcb_ptr, ASYNC_SEND, p->consumer_task);
+
+		if (async_ptr){
+
+			subnet = get_subnet(p->producer_task, p->consumer_task, DMNI_SEND_OP);
+			if (subnet == -1)
+				subnet = PS_SUBNET;
+
+			while (is_send_active(subnet));
+
+			send_message_delivery(p->producer_task, p->consumer_task, p->requesting_processor, (Message *) async_ptr->buffer);
+
+			//The ISend completes after the DMNI reads the message
+			while (is_send_active(subnet));
+
+			complete_async_request(prod_tcb_ptr, async_ptr);
+
+			return 0;
+		}
+
 		//putsv("Request added: ", HAL_get_tick());
-		insert_message_request(p->producer_task, p->consumer_task, p->requesting_processor);
+		insert_message_request(prod_tcb_ptr, p->consumer_task, p->requesting_processor);
 
 	} else { //This means that task was migrated to another PE since its prod_tcb_ptr is null
 
@@ -284,16 +626,29 @@ int handle_message_delivery(volatile ServiceHeader * p, int subnet){
 	int latency;
 	TCB * cons_tcb_ptr;
 	Message * recv_msg_ptr;
+	AsyncRequest * async_ptr;
 
 	//putsv("\nMESSAGE_DELIVERY recebido da producer at time: ", HAL_get_tick());
 
+#if EAGER_MESSAGING
+	//Message pushed with a credit, the consumer may not be waiting for it
+	if (subnet == PS_SUBNET && p->credits)
+		return handle_eager_delivery(p);
+#endif
+
 	cons_tcb_ptr = searchTCB(p->consumer_task);
 
-	while (cons_tcb_ptr->recv_buffer == 0){
+	//The message requested by an IRecv is written into its buffer, the consumer may be running
+	async_ptr = search_async_request(cons_tcb_ptr, ASYNC_RECV, p->producer_task);
+
+	while (async_ptr == 0 && cons_tcb_ptr->recv_buffer == 0){
 		puts("ERROR message delivery send to an invalid consumer\n");
 	}
 
-	recv_msg_ptr = (Message *) cons_tcb_ptr->recv_buffer;
+	if (async_ptr)
+		recv_msg_ptr = (Message *) async_ptr->buffer;
+	else
+		recv_msg_ptr = (Message *) cons_tcb_ptr->recv_buffer;
 
 	if (subnet == PS_SUBNET){ //Read by PS
 
@@ -337,6 +692,15 @@ int handle_message_delivery(volatile ServiceHeader * p, int subnet){
 
 	}
 
+	if (async_ptr){
+
+		complete_async_request(cons_tcb_ptr, async_ptr);
+
+		check_ctp_reconfiguration(cons_tcb_ptr);
+
+		return 0;
+	}
+
 	//Release the consumer buffer info
 	cons_tcb_ptr->recv_buffer = 0;
 
@@ -371,8 +735,9 @@ int send_message(TCB * running_task, unsigned int msg_addr, unsigned int consume
 	Message * prod_msg_ptr;
 	MessageRequest * msg_req_ptr;
 	TCB * cons_tcb_ptr;
+	AsyncRequest * async_ptr;
 
-	if (HAL_is_send_active(PS_SUBNET)){
+	if (is_send_active(PS_SUBNET)){
 		HAL_enable_scheduler_after_syscall();
 		return 0;
 	}
@@ -389,8 +754,14 @@ int send_message(TCB * running_task, unsigned int msg_addr, unsigned int consume
 
 	prod_msg_ptr = (Message *) (running_task->offset |  msg_addr);
 
+	//Keeps the message order: waits the ISends to the same consumer
+	if (search_async_request(running_task, ASYNC_SEND, consumer_task)){
+		HAL_enable_scheduler_after_syscall();
+		return 0;
+	}
+
 	//Searches if there is a message request to the produced message
-	msg_req_ptr = remove_message_request(producer_task, consumer_task);
+	msg_req_ptr = remove_message_request(running_task, consumer_task);
 	//puts("Remove message request\n");
 
 	if (msg_req_ptr){ // If there is a message request for that message
@@ -400,6 +771,14 @@ int send_message(TCB * running_task, unsigned int msg_addr, unsigned int consume
 			//Writes to the consumer page address (local consumer)
 			cons_tcb_ptr = searchTCB(consumer_task);
 
+			//The request comes from an IRecv
+			async_ptr = search_async_request(cons_tcb_ptr, ASYNC_RECV, producer_task);
+
+			if (async_ptr){
+				write_async_msg(cons_tcb_ptr, async_ptr, prod_msg_ptr);
+				return 1;
+			}
+
 			while (cons_tcb_ptr->recv_buffer == 0){
 				puts("ERROR recv buffer not zero\n");
 			}
@@ -430,10 +809,9 @@ int send_message(TCB * running_task, unsigned int msg_addr, unsigned int consume
 			subnet_ret = get_subnet(producer_task, consumer_task, DMNI_SEND_OP);
 			if (subnet_ret == -1)
 				subnet_ret = PS_SUBNET; //If the CTP was not found, then, by default send by PS
-			if (HAL_is_send_active(subnet_ret)){
-				//Restore the message request
-				msg_req_ptr->requested = producer_task;
-				msg_req_ptr->requester = consumer_task;
+			if (is_send_active(subnet_ret)){
+				//Restore the message request, it may come from the hardware table
+				insert_message_request(running_task, consumer_task, msg_req_ptr->requester_proc);
 				return 0;
 			}
 			//**********************************************************
@@ -446,11 +824,26 @@ int send_message(TCB * running_task, unsigned int msg_addr, unsigned int consume
 			//putsv("\nSENDMESSAGE - Enviando delivery at time: ", HAL_get_tick());
 
 			//This is to avoid that the producer task overwrites the send_buffer before message is sent
-			while (HAL_is_send_active(PS_SUBNET));
+			while (is_send_active(PS_SUBNET));
 
 			return 1;
 		}
 	}
+#if EAGER_MESSAGING
+	//Without request the message is pushed if the consumer granted credits to this pair
+#if OUTBOX_DEPTH
+	//The older messages of the outbox are pushed first, by handle_message_credit
+	if (outbox_front(running_task, consumer_task) == 0 && send_eager_message(producer_task, consumer_task, prod_msg_ptr))
+#else
+	if (send_eager_message(producer_task, consumer_task, prod_msg_ptr))
+#endif
+		return 1;
+#endif
+#if OUTBOX_DEPTH
+	//The message is copied to the outbox and the producer continues, the MESSAGE_REQUEST is answered by the kernel
+	if (outbox_push(running_task, consumer_task, prod_msg_ptr))
+		return 1;
+#endif
 #if DEBUG_USER_COMM
 	puts("END SEDN, request not found\n");
 #endif
@@ -462,14 +855,28 @@ int send_message(TCB * running_task, unsigned int msg_addr, unsigned int consume
 }
 
 
-int receive_message(TCB * running_task, unsigned int msg_addr, unsigned int producer_task){
+/** Receive and IRecv. An IRecv returns 1 both when the message was copied and when it was requested,
+ * in the last case the type of async_ptr is set to ASYNC_RECV
+ * \param running_task TCB pointer of the consumer task
+ * \param msg_addr Message address into the consumer page
+ * \param producer_task Producer task index into the application
+ * \param async_ptr Free AsyncRequest of an IRecv (peer and buffer filled), 0 for Receive
+ * \return 1 if the Receive (IRecv) is finished (started), 0 if it must be called again
+ */
+int receive_message(TCB * running_task, unsigned int msg_addr, unsigned int producer_task, AsyncRequest * async_ptr){
 
 	unsigned int consumer_task;
 	unsigned int appID;
 	int producer_PE;
 	int subnet_ret;
+	TCB * prod_tcb_ptr;
+	Message * prod_msg_ptr, * msg_ptr;
+	AsyncRequest * prod_async_ptr;
+#if EAGER_MESSAGING
+	int eager_status;
+#endif
 
-	if (HAL_is_send_active(PS_SUBNET)){
+	if (is_send_active(PS_SUBNET)){
 		HAL_enable_scheduler_after_syscall();
 		return 0;
 	}
@@ -483,12 +890,21 @@ int receive_message(TCB * running_task, unsigned int msg_addr, unsigned int prod
 	puts("\nRECV MSG - prod: "); puts(itoa(producer_task)); putsv(" cons ", consumer_task);
 #endif
 
+	//Only one Receive or IRecv to each producer is pending
+	if (search_async_request(running_task, ASYNC_RECV, producer_task)){
+		HAL_enable_scheduler_after_syscall();
+		return 0;
+	}
+
+	msg_ptr = (Message *) (running_task->offset | msg_addr);
+
 	producer_PE = get_task_location(producer_task);
 
 	//Test if the producer task is not allocated
 	if (producer_PE == -1){
 		//Task is blocked until its a TASK_RELEASE packet
 		running_task->scheduling_ptr->status = BLOCKED;
+		update_ready_bitmaps(running_task->scheduling_ptr);
 		return 0;
 	}
 
@@ -498,18 +914,58 @@ int receive_message(TCB * running_task, unsigned int msg_addr, unsigned int prod
 
 	if (producer_PE == net_address){ //Receive is local
 
+		prod_tcb_ptr = searchTCB(producer_task);
+		prod_msg_ptr = 0;
+		prod_async_ptr = prod_tcb_ptr ? search_async_request(prod_tcb_ptr, ASYNC_SEND, consumer_task) : 0;
+
+#if OUTBOX_DEPTH
+		//The outbox keeps the messages sent before the ISends
+		if (prod_tcb_ptr)
+			prod_msg_ptr = outbox_front(prod_tcb_ptr, consumer_task);
+#endif
+		if (prod_msg_ptr == 0 && prod_async_ptr)
+			prod_msg_ptr = (Message *) prod_async_ptr->buffer;
+
+		//The local producer already sent the message
+		if (prod_msg_ptr){
+
+			msg_ptr->length = prod_msg_ptr->length;
+			DMNI_copy_start((unsigned int) msg_ptr->msg, (unsigned int) prod_msg_ptr->msg, prod_msg_ptr->length);
+
+			//The producer only reuses its buffer after the syscall returns, so it is released during the copy
+			if (prod_async_ptr && prod_msg_ptr == (Message *) prod_async_ptr->buffer)
+				complete_async_request(prod_tcb_ptr, prod_async_ptr);
+#if OUTBOX_DEPTH
+			else
+				outbox_pop(prod_tcb_ptr, consumer_task);
+#endif
+
+			DMNI_copy_wait();
+
+			return 1;
+		}
+
 #if DEBUG_USER_COMM
 		puts("Local receive - insert message request table\n");
 #endif
-		insert_message_request(producer_task, consumer_task, net_address);
+		insert_message_request(prod_tcb_ptr, consumer_task, net_address);
 
 
 	} else { //If the receive is from a remote proc
 
+#if EAGER_MESSAGING
+		eager_status = receive_eager_message(running_task, msg_ptr, producer_task, producer_PE);
+
+		if (eager_status == EAGER_RECEIVED)
+			return 1;
+
+		//While the producer holds credits it pushes the message, the request is only sent in the rendezvous
+		if (eager_status == EAGER_RENDEZVOUS){
+#endif
 		//*************** Deadlock avoidance ************************
 		//Só testa se tiver algo na rede PS pq o CS vai via sinal de req
 		subnet_ret = get_subnet(producer_task, consumer_task, DMNI_RECEIVE_OP);
-		if (subnet_ret == -1 && HAL_is_send_active(PS_SUBNET) ) {
+		if (subnet_ret == -1 && is_send_active(PS_SUBNET) ) {
 			return 0;
 		}
 		//***********************************************************
@@ -517,15 +973,26 @@ int receive_message(TCB * running_task, unsigned int msg_addr, unsigned int prod
 		puts("Remote receive - send message request\n");
 #endif
 		send_message_request(producer_task, consumer_task, producer_PE, net_address);
+#if EAGER_MESSAGING
+		}
+#endif
+
+	}
 
+	//The IRecv returns, the message is written into its buffer when delivered
+	if (async_ptr){
+		async_ptr->type = ASYNC_RECV;
+		return 1;
 	}
 
 	//Stores the receiver buffer
 	running_task->recv_buffer = running_task->offset | msg_addr;
+	running_task->recv_source = producer_task;
 
 	//putsv("END RECVMESSAGE- Message recv_buffer register: ", (running_task->recv_buffer));
 
 	running_task->scheduling_ptr->waiting_msg = 1;
+	update_ready_bitmaps(running_task->scheduling_ptr);
 #if DEBUG_USER_COMM
 	puts("END RECV: task "); puts(itoa(running_task->id)); puts(" is waiting\n");
 #endif
@@ -542,6 +1009,619 @@ int receive_message(TCB * running_task, unsigned int msg_addr, unsigned int prod
 	return 0;
 }
 
+/** ISend syscall. The message is sent as into Send when possible, otherwise the ISend is kept until the
+ * MESSAGE_REQUEST of the consumer (or a credit of the eager protocol) and the task continues
+ * \param running_task TCB pointer of the producer task
+ * \param msg_addr Message address into the producer page
+ * \param consumer_task Consumer task index into the application
+ * \return Handle of the ISend, 0 if it must be called again
+ */
+int isend_message(TCB * running_task, unsigned int msg_addr, unsigned int consumer_task){
+
+	AsyncTable * table = &async_table[running_task - get_tcb_index_ptr(0)];
+	AsyncRequest * async_ptr = 0;
+	int subnet;
+
+	if (is_send_active(PS_SUBNET)){
+		HAL_enable_scheduler_after_syscall();
+		return 0;
+	}
+
+	for(int i=0; i<ASYNC_REQUESTS; i++){
+		if (table->request[i].type == ASYNC_FREE){
+			async_ptr = &table->request[i];
+			break;
+		}
+	}
+
+	//All handles are in use, waits a Wait or Test
+	if (async_ptr == 0){
+		HAL_enable_scheduler_after_syscall();
+		return 0;
+	}
+
+	async_ptr->peer = ((running_task->id >> 8) << 8) | consumer_task;
+	async_ptr->buffer = running_task->offset | msg_addr;
+	async_ptr->done = 0;
+
+	//Deadlock avoidance: send_message must only return 0 when there is no MESSAGE_REQUEST
+	subnet = get_subnet(running_task->id, async_ptr->peer, DMNI_SEND_OP);
+	if (subnet != -1 && HAL_is_send_active(subnet)){
+		HAL_enable_scheduler_after_syscall();
+		return 0;
+	}
+
+	//Without older ISends to the consumer the message may be sent right now
+	if (search_async_request(running_task, ASYNC_SEND, async_ptr->peer) == 0){
+
+		if (send_message(running_task, msg_addr, consumer_task)){
+			async_ptr->type = ASYNC_SEND;
+			async_ptr->done = 1;
+			return (async_ptr - table->request) + 1;
+		}
+
+		//The producer keeps running
+		HAL_disable_scheduler_after_syscall();
+	}
+
+	async_ptr->type = ASYNC_SEND;
+	async_ptr->order = table->order++;
+
+	if (table->pending_sends++ == 0)
+		update_local_producer(running_task);
+
+	return (async_ptr - table->request) + 1;
+}
+
+/** IRecv syscall. The message is requested as into Receive and the task continues
+ * \param running_task TCB pointer of the consumer task
+ * \param msg_addr Message address into the consumer page
+ * \param producer_task Producer task index into the application
+ * \return Handle of the IRecv, 0 if it must be called again
+ */
+int irecv_message(TCB * running_task, unsigned int msg_addr, unsigned int producer_task){
+
+	AsyncTable * table = &async_table[running_task - get_tcb_index_ptr(0)];
+	AsyncRequest * async_ptr = 0;
+
+	for(int i=0; i<ASYNC_REQUESTS; i++){
+		if (table->request[i].type == ASYNC_FREE){
+			async_ptr = &table->request[i];
+			break;
+		}
+	}
+
+	if (async_ptr == 0){
+		HAL_enable_scheduler_after_syscall();
+		return 0;
+	}
+
+	async_ptr->peer = ((running_task->id >> 8) << 8) | producer_task;
+	async_ptr->buffer = running_task->offset | msg_addr;
+	async_ptr->done = 0;
+
+	if (!receive_message(running_task, msg_addr, producer_task, async_ptr))
+		return 0;
+
+	//The message was already available
+	if (async_ptr->type == ASYNC_FREE){
+		async_ptr->type = ASYNC_RECV;
+		async_ptr->done = 1;
+	}
+
+	async_ptr->order = table->order++;
+
+	return (async_ptr - table->request) + 1;
+}
+
+/** Wait syscall, blocks the task until the operation of a handle completes
+ * \param running_task TCB pointer of the task
+ * \param handle Handle returned by ISend or IRecv
+ * \return 1 if the operation is completed, 0 if the task is waiting
+ */
+int wait_request(TCB * running_task, unsigned int handle){
+
+	AsyncTable * table = &async_table[running_task - get_tcb_index_ptr(0)];
+	AsyncRequest * async_ptr;
+
+	if (handle == 0 || handle > ASYNC_REQUESTS)
+		return 1;
+
+	async_ptr = &table->request[handle-1];
+
+	if (async_ptr->type == ASYNC_FREE)
+		return 1;
+
+	if (async_ptr->done){
+		async_ptr->type = ASYNC_FREE;
+		return 1;
+	}
+
+	//complete_async_request releases the task
+	table->waiting = handle - 1;
+
+	running_task->scheduling_ptr->waiting_msg = 1;
+	update_ready_bitmaps(running_task->scheduling_ptr);
+
+	HAL_enable_scheduler_after_syscall();
+
+	return 0;
+}
+
+/** WaitAny syscall, blocks the task until any of its operations completes
+ * \param running_task TCB pointer of the task
+ * \param handle_addr Address into the task page where the completed handle is written, 0 when there is no operation
+ * \return 1 if an operation is completed, 0 if the task is waiting
+ */
+int wait_any_request(TCB * running_task, unsigned int handle_addr){
+
+	AsyncTable * table = &async_table[running_task - get_tcb_index_ptr(0)];
+	int * handle_ptr = (int *) (running_task->offset | handle_addr);
+	int pending = 0;
+
+	for(int i=0; i<ASYNC_REQUESTS; i++){
+
+		if (table->request[i].type == ASYNC_FREE)
+			continue;
+
+		if (table->request[i].done){
+			table->request[i].type = ASYNC_FREE;
+			*handle_ptr = i + 1;
+			return 1;
+		}
+
+		pending = 1;
+	}
+
+	if (!pending){
+		*handle_ptr = 0;
+		return 1;
+	}
+
+	table->waiting = ASYNC_WAIT_ANY;
+	table->any_addr = (unsigned int) handle_ptr;
+
+	running_task->scheduling_ptr->waiting_msg = 1;
+	update_ready_bitmaps(running_task->scheduling_ptr);
+
+	HAL_enable_scheduler_after_syscall();
+
+	return 0;
+}
+
+/** Test syscall, releases the handle when its operation is completed
+ * \param running_task TCB pointer of the task
+ * \param handle Handle returned by ISend or IRecv
+ * \return 1 if the operation is completed, 0 otherwise
+ */
+int test_request(TCB * running_task, unsigned int handle){
+
+	AsyncRequest * async_ptr;
+
+	if (handle == 0 || handle > ASYNC_REQUESTS)
+		return 1;
+
+	async_ptr = &async_table[running_task - get_tcb_index_ptr(0)].request[handle-1];
+
+	if (async_ptr->type != ASYNC_FREE && !async_ptr->done)
+		return 0;
+
+	async_ptr->type = ASYNC_FREE;
+
+	return 1;
+}
+
+/** Gets the number of operations of a task not completed yet
+ * \param tcb_ptr TCB pointer of the task
+ * \return Number of pending ISend and IRecv
+ */
+int async_request_count(TCB * tcb_ptr){
+
+	AsyncTable * table = &async_table[tcb_ptr - get_tcb_index_ptr(0)];
+	int count = 0;
+
+	for(int i=0; i<ASYNC_REQUESTS; i++){
+		if (table->request[i].type != ASYNC_FREE && !table->request[i].done)
+			count++;
+	}
+
+	return count;
+}
+
+/** Releases the handles of a terminated task, the completed ones may not be waited
+ * \param tcb_ptr TCB pointer of the task
+ */
+void clear_async_requests(TCB * tcb_ptr){
+
+	AsyncTable * table = &async_table[tcb_ptr - get_tcb_index_ptr(0)];
+
+	for(int i=0; i<ASYNC_REQUESTS; i++)
+		table->request[i].type = ASYNC_FREE;
+
+	table->waiting = ASYNC_WAIT_NONE;
+}
+
+
+#if EAGER_MESSAGING
+/** Searches the consumer side entry of a remote pair
+ * \param producer_task ID of the producer task, -1 searches a free entry
+ * \param consumer_task ID of the consumer task
+ * \return Pointer to the entry, 0 if not found
+ */
+static EagerPair * search_eager_pair(int producer_task, int consumer_task){
+
+	for(int i=0; i<REQUEST_SIZE; i++){
+		if (eager_pair[i].producer == producer_task && (producer_task == -1 || eager_pair[i].consumer == consumer_task))
+			return &eager_pair[i];
+	}
+
+	return 0;
+}
+
+/** Searches the producer side entry of a remote pair
+ * \param producer_task ID of the producer task, -1 searches a free entry
+ * \param consumer_task ID of the consumer task
+ * \return Pointer to the entry, 0 if not found
+ */
+static EagerCredit * search_eager_credit(int producer_task, int consumer_task){
+
+	for(int i=0; i<REQUEST_SIZE; i++){
+		if (eager_credit[i].producer == producer_task && (producer_task == -1 || eager_credit[i].consumer == consumer_task))
+			return &eager_credit[i];
+	}
+
+	return 0;
+}
+
+/** Assembles and sends a MESSAGE_CREDIT or MESSAGE_CREDIT_REVOKE packet
+ * \param service MESSAGE_CREDIT (to the producer PE) or MESSAGE_CREDIT_REVOKE (to the consumer PE)
+ * \param producer_task ID of the producer task
+ * \param consumer_task ID of the consumer task
+ * \param targetPE Processor address of the other side of the pair
+ * \param credits Number of credits
+ */
+static void send_message_credit(unsigned int service, int producer_task, int consumer_task, unsigned int targetPE, unsigned int credits){
+
+	ServiceHeader *p = get_service_header_slot();
+
+	p->header = targetPE;
+
+	p->service = service;
+
+	p->producer_task = producer_task;
+
+	p->consumer_task = consumer_task;
+
+	p->credits = credits;
+
+	send_packet(p, 0, 0);
+}
+
+/** Returns to the producer the credits released by the consumer
+ * \param pair Consumer side entry of the pair
+ * \param producer_PE Processor address of the producer task
+ */
+static void return_eager_credits(EagerPair * pair, int producer_PE){
+
+	if (pair->to_return == 0)
+		return;
+
+	send_message_credit(MESSAGE_CREDIT, pair->producer, pair->consumer, producer_PE, pair->to_return);
+
+	pair->producer_credits += pair->to_return;
+	pair->to_return = 0;
+}
+
+/** Pushes a message to a remote consumer using one credit of the pair (eager protocol)
+ * \param producer_task ID of the producer task
+ * \param consumer_task ID of the consumer task
+ * \param msg_ptr Message pointer
+ * \return 1 if the message was sent, 0 if the pair has no credit
+ */
+int send_eager_message(int producer_task, int consumer_task, Message * msg_ptr){
+
+	ServiceHeader *p;
+	EagerCredit * credit;
+
+	credit = search_eager_credit(producer_task, consumer_task);
+
+	if (credit == 0 || credit->credits == 0)
+		return 0;
+
+	//The message does not fit into a kernel buffer, gives the credits back and waits the MESSAGE_REQUEST of the consumer
+	if (msg_ptr->length > EAGER_MSG_WORDS){
+		send_message_credit(MESSAGE_CREDIT_REVOKE, producer_task, consumer_task, credit->consumer_PE, credit->credits);
+		credit->credits = 0;
+		return 0;
+	}
+
+#if DEBUG_USER_COMM
+	puts("Eager push - credits "); puts(itoa(credit->credits)); puts("\n");
+#endif
+
+	p = get_service_header_slot();
+
+	p->header = credit->consumer_PE;
+
+	p->service = MESSAGE_DELIVERY;
+
+	p->producer_task = producer_task;
+
+	p->consumer_task = consumer_task;
+
+	p->msg_lenght = msg_ptr->length;
+
+	p->credits = 1;
+
+	send_packet(p, (unsigned int)msg_ptr->msg, msg_ptr->length);
+
+	credit->credits--;
+
+	//This is to avoid that the producer task overwrites the send_buffer before message is sent
+	while (is_send_active(PS_SUBNET));
+
+	return 1;
+}
+
+/** Consumer side of the eager protocol, called by the Receive of a remote producer
+ * \param running_task TCB pointer of the consumer task
+ * \param msg_ptr Message pointer of the consumer task
+ * \param producer_task ID of the producer task
+ * \param producer_PE Processor address of the producer task
+ * \return EAGER_RECEIVED, EAGER_WAITING or EAGER_RENDEZVOUS
+ */
+int receive_eager_message(TCB * running_task, Message * msg_ptr, int producer_task, int producer_PE){
+
+	EagerPair * pair;
+	EagerBuffer * buffer = 0;
+	int consumer_task = running_task->id;
+
+	pair = search_eager_pair(producer_task, consumer_task);
+
+	//First Receive of the pair, reserves buffers while the pool has free ones
+	if (pair == 0){
+
+		pair = search_eager_pair(-1, 0);
+
+		if (pair == 0)
+			return EAGER_RENDEZVOUS;
+
+		pair->producer = producer_task;
+		pair->consumer = consumer_task;
+		pair->quota = EAGER_BUFFERS - eager_reserved;
+		if (pair->quota > EAGER_CREDITS)
+			pair->quota = EAGER_CREDITS;
+		pair->producer_credits = 0;
+		pair->to_return = pair->quota; //Granted by return_eager_credits
+		pair->rendezvous = 0;
+
+		eager_reserved += pair->quota;
+	}
+
+	if (pair->quota == 0)
+		return EAGER_RENDEZVOUS;
+
+	//Oldest message of the pair already pushed by the producer
+	for(int i=0; i<EAGER_BUFFERS; i++){
+		if (eager_buffer[i].producer == producer_task && eager_buffer[i].consumer == consumer_task){
+			if (buffer == 0 || (int)(eager_buffer[i].order - buffer->order) < 0)
+				buffer = &eager_buffer[i];
+		}
+	}
+
+	if (buffer){
+
+		msg_ptr->length = buffer->length;
+
+		DMNI_copy_start((unsigned int) msg_ptr->msg, (unsigned int) buffer->msg, buffer->length);
+
+		//The buffer is only written again by a packet handled after the syscall, so the credits are returned during the copy
+		buffer->producer = -1;
+
+		pair->to_return++;
+
+		if (pair->to_return >= EAGER_CREDIT_BATCH)
+			return_eager_credits(pair, producer_PE);
+
+		DMNI_copy_wait();
+
+		return EAGER_RECEIVED;
+	}
+
+	//The producer has no credit, so no message is on the way
+	if (pair->producer_credits == 0){
+
+		if (pair->rendezvous){
+			pair->rendezvous = 0;
+			return EAGER_RENDEZVOUS;
+		}
+
+		return_eager_credits(pair, producer_PE);
+	}
+
+	return EAGER_WAITING;
+}
+
+/** Handles a MESSAGE_DELIVERY pushed with a credit. The message is written into the consumer buffer when
+ * the consumer is waiting for it, otherwise it is stored into a kernel buffer reserved by the pair
+ * \param p ServiceHeader pointer
+ * \return 0
+ */
+int handle_eager_delivery(volatile ServiceHeader * p){
+
+	EagerPair * pair;
+	EagerBuffer * buffer;
+	TCB * cons_tcb_ptr;
+	Message * recv_msg_ptr;
+	AsyncRequest * async_ptr;
+
+	pair = search_eager_pair(p->producer_task, p->consumer_task);
+
+	cons_tcb_ptr = searchTCB(p->consumer_task);
+
+	while (pair == 0 || cons_tcb_ptr == 0){
+		puts("ERROR eager message delivery send to an invalid consumer\n");
+	}
+
+	pair->producer_credits--;
+
+	async_ptr = search_async_request(cons_tcb_ptr, ASYNC_RECV, p->producer_task);
+
+	if (async_ptr || (cons_tcb_ptr->recv_buffer != 0 && cons_tcb_ptr->scheduling_ptr->waiting_msg && cons_tcb_ptr->recv_source == p->producer_task)){
+
+		recv_msg_ptr = (Message *) (async_ptr ? async_ptr->buffer : cons_tcb_ptr->recv_buffer);
+
+		recv_msg_ptr->length = p->msg_lenght;
+
+		DMNI_read_data((unsigned int)recv_msg_ptr->msg, recv_msg_ptr->length);
+
+		if (async_ptr){
+
+			complete_async_request(cons_tcb_ptr, async_ptr);
+
+		} else {
+
+			cons_tcb_ptr->recv_buffer = 0;
+
+			HAL_release_waiting_task(cons_tcb_ptr);
+
+			cons_tcb_ptr->total_comm += HAL_get_tick() - cons_tcb_ptr->communication_time;
+		}
+
+		check_ctp_reconfiguration(cons_tcb_ptr);
+
+		pair->to_return++;
+
+		if (pair->to_return >= EAGER_CREDIT_BATCH)
+			return_eager_credits(pair, p->source_PE);
+
+		return 0;
+	}
+
+	buffer = 0;
+	for(int i=0; i<EAGER_BUFFERS; i++){
+		if (eager_buffer[i].producer == -1){
+			buffer = &eager_buffer[i];
+			break;
+		}
+	}
+
+	//Never happens, the credits are bounded by the reserved buffers
+	while (buffer == 0){
+		puts("ERROR eager buffer pool is full\n");
+	}
+
+	buffer->producer = p->producer_task;
+	buffer->consumer = p->consumer_task;
+	buffer->order = eager_order++;
+	buffer->length = p->msg_lenght;
+
+	DMNI_read_data((unsigned int)buffer->msg, buffer->length);
+
+	return 0;
+}
+
+/** Handles a MESSAGE_CREDIT, adding the credits granted by a remote consumer to a local producer
+ * \param p ServiceHeader pointer
+ */
+void handle_message_credit(volatile ServiceHeader * p){
+
+	EagerCredit * credit;
+	TCB * prod_tcb_ptr;
+	AsyncRequest * async_ptr;
+#if OUTBOX_DEPTH
+	Message * msg_ptr;
+#endif
+
+	credit = search_eager_credit(p->producer_task, p->consumer_task);
+
+	if (credit == 0){
+
+		credit = search_eager_credit(-1, 0);
+
+		while (credit == 0){
+			puts("ERROR eager credit table is full\n");
+		}
+
+		credit->producer = p->producer_task;
+		credit->consumer = p->consumer_task;
+		credit->credits = 0;
+	}
+
+	credit->consumer_PE = p->source_PE;
+	credit->credits += p->credits;
+
+	prod_tcb_ptr = searchTCB(p->producer_task);
+
+#if OUTBOX_DEPTH
+	//Pushes the messages waiting into the outbox of the producer
+	while (prod_tcb_ptr && (msg_ptr = outbox_front(prod_tcb_ptr, p->consumer_task)) && send_eager_message(p->producer_task, p->consumer_task, msg_ptr))
+		outbox_pop(prod_tcb_ptr, p->consumer_task);
+#endif
+
+	//Then the pending ISends, the loop stops when the credits run out
+	while (prod_tcb_ptr && (async_ptr = search_async_request(prod_tcb_ptr, ASYNC_SEND, p->consumer_task)) && send_eager_message(p->producer_task, p->consumer_task, (Message *) async_ptr->buffer))
+		complete_async_request(prod_tcb_ptr, async_ptr);
+
+#if DEBUG_USER_COMM
+	puts("MESSAGE_CREDIT to "); puts(itoa(p->producer_task)); putsv(" credits ", credit->credits);
+#endif
+}
+
+/** Handles a MESSAGE_CREDIT_REVOKE. The producer has a message larger than EAGER_MSG_WORDS, so the consumer
+ * sends a MESSAGE_REQUEST once all credits are back
+ * \param p ServiceHeader pointer
+ */
+void handle_message_credit_revoke(volatile ServiceHeader * p){
+
+	EagerPair * pair;
+	TCB * cons_tcb_ptr;
+
+	pair = search_eager_pair(p->producer_task, p->consumer_task);
+
+	if (pair == 0)
+		return;
+
+	pair->producer_credits -= p->credits;
+	pair->to_return += p->credits;
+	pair->rendezvous = 1;
+
+	cons_tcb_ptr = searchTCB(p->consumer_task);
+
+	if (pair->producer_credits || cons_tcb_ptr == 0)
+		return;
+
+	//The consumer is already waiting for the message
+	if (search_async_request(cons_tcb_ptr, ASYNC_RECV, p->producer_task) || (cons_tcb_ptr->recv_buffer != 0 && cons_tcb_ptr->scheduling_ptr->waiting_msg && cons_tcb_ptr->recv_source == p->producer_task)){
+
+		pair->rendezvous = 0;
+
+		send_message_request(p->producer_task, p->consumer_task, p->source_PE, net_address);
+	}
+}
+
+/** Releases the eager state of a terminated task: its buffers and reservations as consumer and its credits as producer
+ * \param task_id ID of the task
+ */
+void clear_eager_messaging(int task_id){
+
+	for(int i=0; i<REQUEST_SIZE; i++){
+
+		if (eager_pair[i].producer != -1 && eager_pair[i].consumer == task_id){
+			eager_reserved -= eager_pair[i].quota;
+			eager_pair[i].producer = -1;
+		}
+
+		if (eager_credit[i].producer == task_id)
+			eager_credit[i].producer = -1;
+	}
+
+	for(int i=0; i<EAGER_BUFFERS; i++){
+		if (eager_buffer[i].producer != -1 && eager_buffer[i].consumer == task_id)
+			eager_buffer[i].producer = -1;
+	}
+}
+#endif
 
 
 void send_IO(){
@@ -571,15 +1651,15 @@ void write_local_service_to_MA(unsigned int consumer_id, unsigned int * msg_data
 	msg_address_tgt = (unsigned int *) task_tcb_ptr->recv_buffer;
 
 	//Copies the message from producer to consumer
-	for(int i=0; i<msg_lenght; i++){
-		msg_address_tgt[i] = msg_data[i];
-	}
+	DMNI_copy_start((unsigned int) msg_address_tgt, (unsigned int) msg_data, msg_lenght);
 
 	//puts("LOCAL TASK FEEDED1\n");
 
 	task_tcb_ptr->recv_buffer = 0;
 
 	HAL_release_waiting_task(task_tcb_ptr);
+
+	DMNI_copy_wait();
 	//puts("Task not waitining anymeore 2\n");
 
 }
@@ -647,7 +1727,7 @@ int send_MA(TCB * running_task, unsigned int msg_addr, unsigned int msg_size, un
 	//Scheduler after syscall because the producer cannot send the message
 	//HAL_enable_scheduler_after_syscall();
 
-	if (HAL_is_send_active(PS_SUBNET)){
+	if (is_send_active(PS_SUBNET)){
 #if DEBUG_SERVICE_COMM
 		puts("send active\n");
 #endif
@@ -668,6 +1748,7 @@ int send_MA(TCB * running_task, unsigned int msg_addr, unsigned int msg_size, un
 	if (consumer_PE == -1){
 		//Task is blocked until its a TASK_RELEASE packet
 		running_task->scheduling_ptr->status = BLOCKED;
+		update_ready_bitmaps(running_task->scheduling_ptr);
 #if DEBUG_SERVICE_COMM
 		puts("Consumer PE -1 - return 0\n");
 #endif
@@ -698,16 +1779,16 @@ int send_MA(TCB * running_task, unsigned int msg_addr, unsigned int msg_size, un
 			cons_data = (unsigned int *) consumer_tcb_ptr->recv_buffer;
 
 			//memcopy
-			for(int i=0; i<msg_size; i++){
-				cons_data[i] = prod_data[i];
-			}
+			DMNI_copy_start((unsigned int) cons_data, (unsigned int) prod_data, msg_size);
 
 			//Mark that consumer was populated with a message or not called yet
 			consumer_tcb_ptr->recv_buffer = 0;
 
-			//Release consumer to run
+			//Release consumer to run, it only reads the message after the syscall returns
 			HAL_release_waiting_task(consumer_tcb_ptr);
 
+			DMNI_copy_wait();
+
 #if DEBUG_SERVICE_COMM
 			puts("END SEN - Message found - Write local message\n");
 #endif
@@ -742,6 +1823,7 @@ void receive_MA(TCB * running_task, unsigned int msg_addr){
 	running_task->recv_buffer = (running_task->offset | msg_addr);
 
 	running_task->scheduling_ptr->waiting_msg = 1;
+	update_ready_bitmaps(running_task->scheduling_ptr);
 
 	HAL_enable_scheduler_after_syscall();
 
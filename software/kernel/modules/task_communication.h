@@ -26,6 +26,106 @@
 
 #define REQUEST_SIZE	 MAX_LOCAL_TASKS*(MAX_TASKS_APP-1) //50	//!< Size of the message request array in fucntion of the maximum number of local task and max task per app
 
+#define ASYNC_REQUESTS	 2*MAX_TASKS_APP	//!< Handles of each task, one ISend and one IRecv per task of the application
+
+#define ASYNC_FREE		 0		//!< AsyncRequest type: free handle
+#define ASYNC_SEND		 1		//!< AsyncRequest type: ISend
+#define ASYNC_RECV		 2		//!< AsyncRequest type: IRecv
+
+#define ASYNC_WAIT_NONE	 -1		//!< AsyncTable waiting: the task is not into Wait or WaitAny
+#define ASYNC_WAIT_ANY	 -2		//!< AsyncTable waiting: the task is into WaitAny
+
+/**
+ * \brief Operation started by ISend or IRecv, the user handle is the index into AsyncTable plus 1
+ */
+typedef struct {
+	int type;						//!< ASYNC_FREE, ASYNC_SEND or ASYNC_RECV
+	int peer;						//!< Consumer task ID (ISend) or producer task ID (IRecv)
+	unsigned int buffer;			//!< Message address into the task page
+	unsigned int order;				//!< Issue order, the ISends to the same consumer are delivered in FIFO
+	unsigned int done;				//!< The operation completed but its handle was not waited yet
+} AsyncRequest;
+
+/**
+ * \brief Non-blocking operations of a local task
+ */
+typedef struct {
+	AsyncRequest request[ASYNC_REQUESTS];
+	int 		 waiting;			//!< Handle index blocking the task into Wait, ASYNC_WAIT_ANY or ASYNC_WAIT_NONE
+	unsigned int any_addr;			//!< Address where WaitAny writes the completed handle
+	unsigned int pending_sends;		//!< ISends waiting the MESSAGE_REQUEST of the consumer
+	unsigned int order;
+} AsyncTable;
+
+#if OUTBOX_DEPTH
+#define OUTBOX_MSG_WORDS	128		//!< Max message length buffered by the outbox, larger messages wait the MESSAGE_REQUEST into the Send
+
+/**
+ * \brief Outbox slot, keeps a copy of a message sent before its MESSAGE_REQUEST
+ */
+typedef struct {
+	int length;
+	int msg[OUTBOX_MSG_WORDS];
+	int next;						//!< Next slot of the same consumer (or next free slot), -1 at the end of the list
+} OutboxSlot;
+
+/**
+ * \brief Bounded outbox of a local producer task. The slots of each consumer are linked in FIFO order,
+ * so the message answering a MESSAGE_REQUEST is found in constant time
+ */
+typedef struct {
+	OutboxSlot 	 slot[OUTBOX_DEPTH];
+	int 		 head[MAX_TASKS_APP];	//!< Oldest slot of each consumer, indexed by the consumer task index into the application
+	int 		 tail[MAX_TASKS_APP];	//!< Newest slot of each consumer
+	int 		 free;					//!< First free slot
+	unsigned int count;					//!< Used slots
+} Outbox;
+#endif
+
+#if EAGER_MESSAGING
+#define EAGER_BUFFERS		8		//!< Kernel receive buffers shared by the local consumers, each buffer backs one credit
+#define EAGER_MSG_WORDS		128		//!< Max message length pushed with a credit, larger messages use MESSAGE_REQUEST
+#define EAGER_CREDITS		2		//!< Credits granted to each remote producer/consumer pair while there are free buffers
+#define EAGER_CREDIT_BATCH	1		//!< Consumed credits returned to the producer in a single MESSAGE_CREDIT
+
+#define EAGER_RECEIVED		1		//!< receive_eager_message: the message was copied from a kernel buffer
+#define EAGER_WAITING		0		//!< receive_eager_message: the producer holds credits and will push the message
+#define EAGER_RENDEZVOUS	-1		//!< receive_eager_message: the consumer must send a MESSAGE_REQUEST
+
+/**
+ * \brief Consumer side of a remote pair, the credits of a pair are bounded by the buffers reserved to it (quota)
+ */
+typedef struct {
+	int producer;					//!< Producer task ID, -1 when the entry is free
+	int consumer;					//!< Consumer task ID
+	unsigned int quota;				//!< Kernel buffers reserved to the pair, 0 means that the pair always uses MESSAGE_REQUEST
+	unsigned int producer_credits;	//!< Credits granted to the producer and not used yet
+	unsigned int to_return;			//!< Credits released by the consumer and not returned to the producer yet
+	unsigned int rendezvous;		//!< The producer revoked its credits, the next Receive sends a MESSAGE_REQUEST
+} EagerPair;
+
+/**
+ * \brief Producer side of a remote pair
+ */
+typedef struct {
+	int producer;					//!< Producer task ID, -1 when the entry is free
+	int consumer;					//!< Consumer task ID
+	int consumer_PE;				//!< Consumer processor address
+	unsigned int credits;			//!< Messages that can be pushed without a MESSAGE_REQUEST
+} EagerCredit;
+
+/**
+ * \brief Kernel buffer storing a message pushed before the consumer called Receive
+ */
+typedef struct {
+	int producer;					//!< Producer task ID, -1 when the buffer is free
+	int consumer;					//!< Consumer task ID
+	unsigned int order;				//!< Arrival order, keeps the messages of a pair in FIFO
+	int length;
+	int msg[EAGER_MSG_WORDS];
+} EagerBuffer;
+#endif
+
 /**
  * \brief This structure stores the message requests used to implement the blocking Receive MPI
  */
@@ -33,22 +133,39 @@ typedef struct {
     int requester;             	//!< Store the requested task id ( task that performs the Receive() API )
     int requested;             	//!< Stores the requested task id ( task that performs the Send() API )
     int requester_proc;			//!< Stores the requester processor address
+    int next;					//!< Next request of the same producer (or next free entry), -1 at the end of the list
 } MessageRequest;
 
 
 void init_communication();
 
-int insert_message_request(int, int, int);
+int insert_message_request(TCB *, int, int);
+
+int search_message_request(TCB *, int);
 
-int search_message_request(int, int);
+MessageRequest * remove_message_request(TCB *, int);
 
-MessageRequest * remove_message_request(int, int);
+int remove_all_requested_msgs(TCB *, unsigned int *);
 
-int remove_all_requested_msgs(int, unsigned int *);
+void set_local_producer(TCB *, int);
 
 int send_message(TCB *, unsigned int, unsigned int);
 
-int receive_message(TCB *, unsigned int, unsigned int);
+int receive_message(TCB *, unsigned int, unsigned int, AsyncRequest *);
+
+int isend_message(TCB *, unsigned int, unsigned int);
+
+int irecv_message(TCB *, unsigned int, unsigned int);
+
+int wait_request(TCB *, unsigned int);
+
+int wait_any_request(TCB *, unsigned int);
+
+int test_request(TCB *, unsigned int);
+
+int async_request_count(TCB *);
+
+void clear_async_requests(TCB *);
 
 void send_message_request(int, int, unsigned int, unsigned int);
 
@@ -58,6 +175,24 @@ int handle_message_delivery(volatile ServiceHeader *, int);
 
 int handle_message_request(volatile ServiceHeader *);
 
+#if OUTBOX_DEPTH
+int outbox_count(TCB *);
+#endif
+
+#if EAGER_MESSAGING
+int send_eager_message(int, int, Message *);
+
+int receive_eager_message(TCB *, Message *, int, int);
+
+int handle_eager_delivery(volatile ServiceHeader *);
+
+void handle_message_credit(volatile ServiceHeader *);
+
+void handle_message_credit_revoke(volatile ServiceHeader *);
+
+void clear_eager_messaging(int);
+#endif
+
 /*MA API functions*/
 int send_MA(TCB *, unsigned int, unsigned int, unsigned int);
 
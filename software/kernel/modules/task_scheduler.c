@@ -12,6 +12,9 @@
  *
  * \detailed The main function of this module is the LST algorithm, which is called by kernel_slave. It
  * returns the pointer for the selected task to execute into the processor.
+ * The ready tasks of each class (service, RT and BE) are kept into bitmaps, updated at each task status or
+ * waiting_msg change, so only the RT tasks are visited at each call. When EDF_SCHEDULER
+ * is enabled (task_scheduler: edf into the testcase yaml) the RT tasks follow the earliest deadline instead of the least slack time.
  * This module is used only by the slave kernel
  */
 
@@ -30,6 +33,19 @@ unsigned int instant_overhead;					//!<Used to dynamically estimate the schedule
 unsigned int cpu_utilization = 0;				//!<RT CPU utilization, only filled with RT constraints
 unsigned int cluster_master_address;			//!<Only external variable in slave. Variable store the same information than cluster_master_address of kernel_slave.c
 
+//Bitmaps indexed as the scheduling array, kept by update_ready_bitmaps at each change of the task status or waiting_msg
+unsigned int ready_service;						//!<Service tasks ready to execute
+unsigned int ready_rt;							//!<Real-time tasks ready to execute
+unsigned int ready_be;							//!<Best-effort tasks ready to execute
+unsigned int rt_tasks;							//!<Real-time tasks that are not FREE, MIGRATING or BLOCKED, visited by update_real_time
+Scheduling * last_scheduled;					//!<Task selected by the last scheduler call
+
+//Filled by update_real_time at each scheduler call
+Scheduling * rt_candidate;						//!<READY RT task selected by the policy: least slack time (LST) or earliest deadline (EDF_SCHEDULER)
+Scheduling * least_slack;						//!<READY RT task with the least slack time
+unsigned int second_slack;						//!<Least slack time of the other READY RT tasks, 0 if there is none
+unsigned int closer_period;						//!<Closer end of period of the SLEEPING or waiting RT tasks, 0 if there is none
+
 
 void send_deadline_miss_report(Scheduling * real_time_task){
 
@@ -111,6 +127,13 @@ unsigned int get_time_slice(){
 	return time_slice;
 }
 
+/**Gets the CPU utilization reserved by the RT tasks
+ * \return The sum of the RT tasks utilization, in percentage of the full CPU clock
+ */
+unsigned int get_cpu_utilization(){
+	return cpu_utilization;
+}
+
 /**Initializes the scheduling array with valid pointers
  *  \param sched_ptr Pointer to pointer of the scheduler variable into TCB structure
  *  \param tcb_index TCB array index
@@ -148,6 +171,8 @@ void clear_scheduling(Scheduling * scheduling_tcb){
 	scheduling_tcb->running_start_time = 0;
 	scheduling_tcb->utilization = 0;
 	scheduling_tcb->waiting_msg = 0;
+
+	update_ready_bitmaps(scheduling_tcb);
 }
 
 /**Updates the task slack time. The slack time is the time until the task start the next period,
@@ -217,6 +242,8 @@ void real_time_task(Scheduling * real_time_task, unsigned int period, int deadli
 
 	real_time_task->deadline_miss = 0;
 
+	update_ready_bitmaps(real_time_task);
+
 //#if DEBUG
 	putsv("\n---- RealTime called\nAddress: ", (unsigned int) real_time_task);
 	putsv("Ready time: ", real_time_task->ready_time);
@@ -229,55 +256,94 @@ void real_time_task(Scheduling * real_time_task, unsigned int period, int deadli
 
 }
 
-/**A simple round-robin scheduler
- *  \return The next round index
+/**Gets the index of the least significant bit set in constant time, the CPU has no count zeros instruction
+ *  \param bitmap Bitmap with at least one bit set
+ *  \return Index of the first bit set
  */
-unsigned int round_robin(){
+unsigned int first_set_bit(unsigned int bitmap){
 
-	static unsigned int round_robin = 0;
+	static const unsigned char debruijn_index[32] = {
+		0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+		31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+	};
+
+	return debruijn_index[((bitmap & -bitmap) * 0x077CB531) >> 27];
+}
+
+/**Updates the ready bitmaps with the current state of a task. Must be called after each change of the task
+ * status, waiting_msg, deadline or is_service_task
+ *  \param task Scheduling pointer of the task
+ */
+void update_ready_bitmaps(Scheduling * task){
+
+	unsigned int task_bit;
+
+	task_bit = 1 << (task - scheduling);
+
+	ready_service &= ~task_bit;
+	ready_rt &= ~task_bit;
+	ready_be &= ~task_bit;
+	rt_tasks &= ~task_bit;
+
+	if (task->status == FREE || task->status == MIGRATING || task->status == BLOCKED)
+		return;
+
+	if (task->deadline != NO_DEADLINE)
+		rt_tasks |= task_bit;
 
-	if (round_robin == MAX_LOCAL_TASKS-1)
-		round_robin = 0;
+	//A RUNNING task is still able to execute, it goes to READY at the next scheduler call
+	if ((task->status != READY && task->status != RUNNING) || task->waiting_msg)
+		return;
+
+	if (((TCB *) task->tcb_ptr)->is_service_task)
+		ready_service |= task_bit;
+	else if (task->deadline != NO_DEADLINE)
+		ready_rt |= task_bit;
 	else
-		round_robin++;
+		ready_be |= task_bit;
+}
+
+/**A simple round-robin scheduler over a ready bitmap
+ *  \param ready Bitmap of the ready tasks, indexed as the scheduling array
+ *  \return The Scheduling pointer of the next ready task in the round, 0 if there is no ready task
+ */
+Scheduling * round_robin(unsigned int ready){
+
+	static unsigned int round_robin = 0;
+	unsigned int next;
+
+	if (ready == 0)
+		return 0;
+
+	//Ready tasks after the last selected one, otherwise the round starts again
+	next = ready & ~((2 << round_robin) - 1);
+	if (next == 0)
+		next = ready;
+
+	round_robin = first_set_bit(next);
 
 	//putsv("Return index : ", round_robin);
-	return round_robin;
+	return &scheduling[round_robin];
 }
 
 
-/**This algorithm try to given an extra time slice to task selected by LST.
- * The main approach is looking for the READY task slack time and the closer end of period
+/**This algorithm try to given an extra time slice to task selected by the scheduler.
+ * The main approach is looking for the READY task slack time and the closer end of period, both kept by update_real_time
  * \param scheduled Scheduled task pointer
  * \param time Current system time
  */
 void inline dynamic_slice_time(Scheduling *scheduled, unsigned int time){
 
-	Scheduling * task;
-	unsigned int closer_period, second_LST, end_period;
+	unsigned int second_LST;
 
-	closer_period = 0;
+	//The task with the lest slack time, other than the scheduled one
 	second_LST = 0;
-
-	//---------------------------------------------------
-	//Searches for the second task with the lest slack time and the closer end of period
-	for(int i=0; i<MAX_LOCAL_TASKS; i++){
-		task = &scheduling[i];
-
-		if (task->deadline == NO_DEADLINE || task == scheduled)
-			continue;
-
-		if (task->status == SLEEPING || task->waiting_msg){
-			end_period = task->ready_time + task->period;
-			if (!closer_period || end_period < closer_period){
-				closer_period = end_period;
-			}
-		//Only RUNNING, READY tasks
-		} else if (scheduled->slack_time > 0 && (!second_LST || second_LST > task->slack_time)){
-			second_LST = task->slack_time;
-		}
+	if (scheduled->slack_time > 0){
+		if (scheduled == least_slack)
+			second_LST = second_slack;
+		else if (least_slack)
+			second_LST = least_slack->slack_time;
 	}
-	//---------------------------------------------------
 
 	//Decides to extend the time slice
 	if (second_LST && second_LST < time_slice){
@@ -292,26 +358,25 @@ void inline dynamic_slice_time(Scheduling *scheduled, unsigned int time){
 
 
 /**Updates the dynamic RT parameters for all RT tasks. The dynamic RT parameters are: remaining execution time,
- * status, slack-time
+ * status, slack-time.
+ * Only the RT tasks are visited, since their status depends on the current time. In the same pass it ranks the
+ * READY RT tasks and keeps the closer end of period
  *  \param current_time Current system time
  */
 void inline update_real_time(unsigned int current_time){
 
 	Scheduling * task;
 	//Scheduling * running_task = 0;
+	unsigned int pending, end_period;
 
-	for(int i=0; i<MAX_LOCAL_TASKS; i++){
+	rt_candidate = 0;
+	least_slack = 0;
+	second_slack = 0;
+	closer_period = 0;
 
-		task = &scheduling[i];
+	for(pending = rt_tasks; pending; pending &= pending - 1){
 
-		//If the current task a BE task then continue the loop
-		if (task->deadline == NO_DEADLINE || task->status == FREE || task->status == MIGRATING || task->status == BLOCKED){
-			//If the current task is BE only set it status to READY
-			if (task->status == RUNNING && !task->waiting_msg){
-				task->status = READY;
-			}
-			continue;
-		}
+		task = &scheduling[first_set_bit(pending)];
 
 #if DEBUG
 		putsv("\n----\nTask address: ", (unsigned int)task);
@@ -381,19 +446,50 @@ void inline update_real_time(unsigned int current_time){
 		if (task->status != SLEEPING){
 			update_slack_time(task, current_time);
 		}
+
+		update_ready_bitmaps(task);
+
+		if (task->status == SLEEPING || task->waiting_msg){
+
+			end_period = task->ready_time + task->period;
+			if (!closer_period || end_period < closer_period){
+				closer_period = end_period;
+			}
+
+		} else if (task->status == READY){
+
+			//Keeps the least slack time and the least slack time of the other tasks, used by dynamic_slice_time
+			if (least_slack == 0 || task->slack_time < least_slack->slack_time){
+				if (least_slack)
+					second_slack = least_slack->slack_time;
+				least_slack = task;
+			} else if (!second_slack || task->slack_time < second_slack){
+				second_slack = task->slack_time;
+			}
+
+#if EDF_SCHEDULER
+			//Earliest absolute deadline
+			if (rt_candidate == 0 || (int)((task->ready_time + task->deadline) - (rt_candidate->ready_time + rt_candidate->deadline)) < 0){
+				rt_candidate = task;
+			}
+#endif
+		}
 	}
+
+#if !EDF_SCHEDULER
+	rt_candidate = least_slack;
+#endif
 }
 
-/**The LST algorithm called by kernel slave. It select the next RT task with the least slack time,
- * or the next BE task following a round-robin order
+/**The LST algorithm called by kernel slave. It select the next RT task with the least slack time (or the earliest
+ * deadline with EDF_SCHEDULER), or the next BE task following a round-robin order.
+ * The selection works over the ready bitmaps, only the RT tasks are visited by update_real_time
  *  \param current_time Current system time
  *  \return The Scheduling pointer of the scheduled task
  */
 Scheduling * LST(unsigned int current_time){
 
-	Scheduling * scheduled_task, * task;
-	TCB * tcb_ptr;
-	unsigned int end_period;
+	Scheduling * scheduled_task;
 
 	instant_overhead = current_time;
 //putsv("\nSC: ",current_time);
@@ -404,55 +500,25 @@ Scheduling * LST(unsigned int current_time){
 
 	current_time+= schedule_overhead;
 
+	//A BE task only leaves the RUNNING status, the RT tasks are updated by update_real_time
+	if (last_scheduled && last_scheduled->status == RUNNING && last_scheduled->deadline == NO_DEADLINE && !last_scheduled->waiting_msg){
+		last_scheduled->status = READY;
+	}
+
 	//Updates real-time parameters: slack_time, ready_time, remaining_exe_time, status
 	update_real_time(current_time);
 
-	//Initializes scheduled_task pointer as zero
-	scheduled_task = 0;
-
-	//Search for a service task ready to execute
-	for(int i=0; i<MAX_LOCAL_TASKS; i++){
-
-		task = &scheduling[round_robin()];
-
-		tcb_ptr = (TCB *)task->tcb_ptr;
+	//Service tasks have the highest priority
+	scheduled_task = round_robin(ready_service);
 
-		if (tcb_ptr->is_service_task && task->status == READY && !task->waiting_msg){
-
-			scheduled_task = task;
-
-			break;
-		}
-	}
-	//End new code added specifically to set service task as high priority. Please remove the IF above to return to the previous version
-
-	//Search for a real-time task with the LEAST SLACK TIME
+	//Real-time task with the LEAST SLACK TIME (or the earliest deadline), ranked by update_real_time
 	if (scheduled_task == 0){
-		for(int i=0; i<MAX_LOCAL_TASKS; i++){
-
-			task = &scheduling[i];
-
-			if (task->deadline != NO_DEADLINE && task->status == READY && !task->waiting_msg){
-
-				if (scheduled_task == 0 || (task->slack_time < scheduled_task->slack_time) ){
-					scheduled_task = task;
-				}
-			}
-		}
+		scheduled_task = rt_candidate;
 	}
 
 	//If no real-time task are scheduled, selects the next round-robin BE task
 	if (scheduled_task == 0){
-
-		for(int i=0; i<MAX_LOCAL_TASKS; i++){
-
-			task = &scheduling[round_robin()];
-
-			if (task->status == READY && !task->waiting_msg) {
-				scheduled_task = task;
-				break;
-			}
-		}
+		scheduled_task = round_robin(ready_be);
 	}
 
 	//If at least one task has been selected (BE or RT)
@@ -484,24 +550,9 @@ Scheduling * LST(unsigned int current_time){
 
 	} else { //Schedules Idle
 
-		time_slice = 0;
-
-		//Searches for the next end of period
-		for(int i=0; i<MAX_LOCAL_TASKS; i++){
-			task = &scheduling[i];
-
-			if (task->deadline == NO_DEADLINE)
-				continue;
-
-			if (task->status == SLEEPING || task->waiting_msg){
-				end_period = task->ready_time + task->period;
-				if (time_slice == 0 || end_period < time_slice){
-					time_slice = end_period;
-				}
-			}
-		}
-		if (time_slice != 0)
-			time_slice = time_slice - current_time;
+		//Sleeps until the next end of period
+		if (closer_period != 0)
+			time_slice = closer_period - current_time;
 		else
 			time_slice = MAX_TIME_SLICE;
 
@@ -514,5 +565,7 @@ Scheduling * LST(unsigned int current_time){
 	instant_overhead = HAL_get_tick() - instant_overhead;
 	schedule_overhead = (unsigned int) (schedule_overhead + instant_overhead) / 2;
 
+	last_scheduled = scheduled_task;
+
 	return scheduled_task;
 }
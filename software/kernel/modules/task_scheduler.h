@@ -78,10 +78,14 @@ void real_time_task(Scheduling *, unsigned int, int, unsigned int);
 
 unsigned int get_time_slice();
 
+unsigned int get_cpu_utilization();
+
 void init_scheduling_ptr(Scheduling **, int);
 
 void clear_scheduling(Scheduling *);
 
+void update_ready_bitmaps(Scheduling *);
+
 void send_real_time_constraints(Scheduling *);
 
 Scheduling * LST(unsigned int);